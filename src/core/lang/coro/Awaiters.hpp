@@ -0,0 +1,63 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#pragma once
+#include <coroutine>
+
+#include <lang/thread/Dispatcher.hpp>
+#include <lang/thread/Future.hpp>
+
+namespace age {
+namespace meta {
+/// \brief Suspends the coroutine and resumes it as a task of the executor. E is anything with a submit taking a
+/// cds::Function<void()>, such as Executor or Dispatcher.
+template <typename E> class ResumeOn {
+public:
+  explicit ResumeOn(E& executor) noexcept : _executor(executor) {}
+
+  [[nodiscard]] auto await_ready() const noexcept { return false; }
+
+  // The coroutine may be resumed, and this destroyed, before submit returns: nothing of this is used afterwards
+  auto await_suspend(std::coroutine_handle<> handle) const noexcept(false) -> void {
+    _executor.submit([handle] { handle.resume(); });
+  }
+
+  auto await_resume() const noexcept -> void {
+    // empty on purpose
+  }
+
+private:
+  E& _executor;
+};
+
+template <typename T> class FutureAwaiter {
+public:
+  explicit FutureAwaiter(Future<T> future) noexcept : _future(std::move(future)) {}
+
+  [[nodiscard]] auto await_ready() const noexcept { return _future.ready(); }
+
+  auto await_suspend(std::coroutine_handle<> handle) const noexcept(false) -> void {
+    FutureAccess::state(_future)->onReady([handle] { handle.resume(); });
+  }
+
+  auto await_resume() const noexcept(false) -> T { return _future.get(); }
+
+private:
+  Future<T> _future;
+};
+} // namespace meta
+
+/// \brief co_await resumeOn(executor) continues the coroutine on a thread of the executor.
+template <typename E> [[nodiscard]] auto resumeOn(E& executor) noexcept { return meta::ResumeOn<E>(executor); }
+
+/// \brief co_await resumeOnMainThread() continues the coroutine on the main thread, on its next Dispatcher drain, e.g.
+/// to update widgets once a background computation is done.
+[[nodiscard]] inline auto resumeOnMainThread() noexcept(false) { return resumeOn(Dispatcher::mainThread()); }
+
+/// \brief Awaiting a future yields its value, or rethrows its exception. If the future is not ready, the coroutine
+/// resumes on the thread setting it; co_await resumeOn afterwards to continue elsewhere.
+template <typename T> [[nodiscard]] auto operator co_await(Future<T> future) noexcept {
+  return meta::FutureAwaiter<T>(std::move(future));
+}
+} // namespace age
@@ -0,0 +1,179 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#pragma once
+#include <cassert>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+#include <lang/thread/Future.hpp>
+
+namespace age {
+template <typename T = void> class Task;
+
+namespace meta {
+template <typename T> class TaskPromiseBase {
+public:
+  /// \brief Transfers to the awaiting coroutine instead of resuming it, so that long chains of tasks completing
+  /// synchronously do not grow the stack.
+  struct FinalAwaiter {
+    [[nodiscard]] auto await_ready() const noexcept { return false; }
+
+    template <typename P> auto await_suspend(std::coroutine_handle<P> handle) noexcept -> std::coroutine_handle<> {
+      if (auto continuation = handle.promise()._continuation; continuation) {
+        return continuation;
+      }
+      return std::noop_coroutine();
+    }
+
+    auto await_resume() const noexcept -> void {
+      // empty on purpose
+    }
+  };
+
+  [[nodiscard]] auto initial_suspend() const noexcept -> std::suspend_always { return {}; }
+  [[nodiscard]] auto final_suspend() const noexcept -> FinalAwaiter { return {}; }
+  void unhandled_exception() noexcept { _exception = std::current_exception(); }
+
+  std::coroutine_handle<> _continuation;
+  std::exception_ptr _exception;
+
+protected:
+  auto rethrow() const noexcept(false) -> void {
+    if (_exception) {
+      std::rethrow_exception(_exception);
+    }
+  }
+};
+
+template <typename T> class TaskPromise : public TaskPromiseBase<T> {
+public:
+  auto get_return_object() noexcept -> Task<T> {
+    return Task<T> {std::coroutine_handle<TaskPromise>::from_promise(*this)};
+  }
+
+  template <typename From>
+    requires std::convertible_to<From, T>
+  auto return_value(From&& from) noexcept(false) -> void {
+    _value.emplace(std::forward<From>(from));
+  }
+
+  auto result() noexcept(false) -> T {
+    this->rethrow();
+    return std::move(*_value);
+  }
+
+private:
+  std::optional<T> _value;
+};
+
+template <> class TaskPromise<void> : public TaskPromiseBase<void> {
+public:
+  auto get_return_object() noexcept -> Task<void>;
+
+  auto return_void() const noexcept -> void {
+    // empty on purpose
+  }
+
+  auto result() noexcept(false) -> void { rethrow(); }
+};
+
+/// \brief Coroutine started eagerly and destroyed when it ends, owned by nobody.
+struct Detached {
+  struct promise_type {
+    [[nodiscard]] auto get_return_object() const noexcept -> Detached { return {}; }
+    [[nodiscard]] auto initial_suspend() const noexcept -> std::suspend_never { return {}; }
+    [[nodiscard]] auto final_suspend() const noexcept -> std::suspend_never { return {}; }
+    void unhandled_exception() const noexcept { std::terminate(); }
+
+    auto return_void() const noexcept -> void {
+      // empty on purpose
+    }
+  };
+};
+} // namespace meta
+
+/// \brief Lazily started coroutine producing a T. It runs when awaited, resuming the awaiting coroutine once done by
+/// symmetric transfer. Exceptions escaping it are rethrown to the awaiting coroutine. Tasks are started from regular
+/// code with launch, which returns a Future of the result.
+///
+/// Where a task runs follows from what it awaits: co_await resumeOn(executor) or resumeOnMainThread() hop threads, and
+/// awaiting a Future resumes on the thread setting it. See lang/coro/Awaiters.hpp.
+template <typename T> class Task {
+public:
+  using promise_type = meta::TaskPromise<T>;
+
+  explicit Task(std::coroutine_handle<promise_type> handle) noexcept : _handle(handle) {}
+  Task(Task const&) = delete;
+  Task(Task&& task) noexcept : _handle(std::exchange(task._handle, nullptr)) {}
+  ~Task() noexcept {
+    if (_handle) {
+      _handle.destroy();
+    }
+  }
+
+  auto operator=(Task const&) = delete;
+  auto operator=(Task&& task) noexcept -> Task& {
+    if (this != &task) {
+      if (_handle) {
+        _handle.destroy();
+      }
+      _handle = std::exchange(task._handle, nullptr);
+    }
+    return *this;
+  }
+
+  /// \brief Awaits the result. The task must hold a coroutine, i.e. not have been moved from.
+  auto operator co_await() const noexcept {
+    assert(_handle && "Awaiting a moved-from Task");
+    struct Awaiter {
+      [[nodiscard]] auto await_ready() const noexcept { return handle.done(); }
+
+      auto await_suspend(std::coroutine_handle<> awaiting) const noexcept -> std::coroutine_handle<> {
+        handle.promise()._continuation = awaiting;
+        return handle;
+      }
+
+      auto await_resume() const noexcept(false) -> T { return handle.promise().result(); }
+
+      std::coroutine_handle<promise_type> handle;
+    };
+
+    return Awaiter {_handle};
+  }
+
+private:
+  std::coroutine_handle<promise_type> _handle;
+};
+
+inline auto meta::TaskPromise<void>::get_return_object() noexcept -> Task<void> {
+  return Task<void> {std::coroutine_handle<TaskPromise>::from_promise(*this)};
+}
+
+namespace meta {
+template <typename T> auto runToPromise(Task<T> task, Promise<T> promise) -> Detached {
+  try {
+    if constexpr (cds::meta::IsVoid<T>::value) {
+      co_await task;
+      (void) promise.setValue();
+    } else {
+      (void) promise.setValue(co_await task);
+    }
+  } catch (...) {
+    (void) promise.setException(std::current_exception());
+  }
+}
+} // namespace meta
+
+/// \brief Starts the task on the calling thread, which runs it until its first suspension, and returns the future of
+/// its result.
+template <typename T> auto launch(Task<T> task) noexcept(false) -> Future<T> {
+  Promise<T> promise;
+  auto future = promise.future();
+  meta::runToPromise(std::move(task), std::move(promise));
+  return future;
+}
+} // namespace age
@@ -0,0 +1,47 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include "AsyncFile.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+namespace {
+using std::ios_base;
+} // namespace
+
+namespace age {
+auto readFile(std::filesystem::path path, Executor& executor) noexcept(false) -> Future<std::string> {
+  return runAsync(
+      [path = std::move(path)] {
+        std::ifstream file(path, ios_base::binary);
+        if (!file) {
+          throw ios_base::failure("Unable to open " + path.string() + " for reading");
+        }
+
+        std::string contents {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+        if (file.bad()) {
+          throw ios_base::failure("Unable to read " + path.string());
+        }
+        return contents;
+      },
+      executor);
+}
+
+auto writeFile(std::filesystem::path path, std::string contents, Executor& executor) noexcept(false) -> Future<void> {
+  return runAsync(
+      [path = std::move(path), contents = std::move(contents)] {
+        if (path.has_parent_path()) {
+          std::filesystem::create_directories(path.parent_path());
+        }
+
+        std::ofstream file(path, ios_base::binary | ios_base::trunc);
+        if (!file.write(contents.data(), static_cast<std::streamsize>(contents.size())).flush()) {
+          throw ios_base::failure("Unable to write " + path.string());
+        }
+      },
+      executor);
+}
+} // namespace age
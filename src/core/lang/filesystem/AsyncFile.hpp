@@ -0,0 +1,23 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#pragma once
+#include <filesystem>
+#include <string>
+
+#include <lang/thread/Executor.hpp>
+#include <lang/thread/Future.hpp>
+
+namespace age {
+/// \brief Reads the whole file as a task of the executor, so that neither the caller nor an awaiting coroutine blocks
+/// on the I/O. The future fails with std::ios_base::failure if the file cannot be read. Pass a dedicated executor for
+/// slow devices, so that the I/O does not hold workers of the shared one.
+auto readFile(std::filesystem::path path, Executor& executor = Executor::shared()) noexcept(false)
+    -> Future<std::string>;
+
+/// \brief Replaces the contents of the file as a task of the executor, creating its parent directories. The future
+/// fails with std::ios_base::failure if the file cannot be written.
+auto writeFile(std::filesystem::path path, std::string contents, Executor& executor = Executor::shared()) noexcept(false)
+    -> Future<void>;
+} // namespace age
@@ -0,0 +1,129 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include "AtomicFileWriter.hpp"
+
+#include <cerrno>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#if defined(__linux) | defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#define AGE_FILE_SYNC_AVAILABLE true
+#else
+#include <fstream>
+#define AGE_FILE_SYNC_AVAILABLE false
+#endif
+
+namespace {
+using std::ios_base;
+using std::filesystem::path;
+
+auto failure(std::string const& what, path const& file, std::error_code error) {
+  return ios_base::failure(what + " " + file.string(), error);
+}
+
+auto lastError() noexcept { return std::error_code(errno, std::generic_category()); }
+
+#if AGE_FILE_SYNC_AVAILABLE
+/// \brief Closes the descriptor, keeping errno from the failure being reported.
+auto closePreservingError(int descriptor) noexcept {
+  auto const error = errno;
+  ::close(descriptor);
+  errno = error;
+}
+
+auto writeSynced(path const& file, std::string_view contents) noexcept(false) -> void {
+  auto const descriptor = ::open(file.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (descriptor < 0) {
+    throw failure("Unable to open", file, lastError());
+  }
+
+  while (!contents.empty()) {
+    auto const written = ::write(descriptor, contents.data(), contents.size());
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+
+    if (written < 0) {
+      closePreservingError(descriptor);
+      throw failure("Unable to write", file, lastError());
+    }
+    contents.remove_prefix(static_cast<std::size_t>(written));
+  }
+
+  if (::fsync(descriptor) != 0) {
+    closePreservingError(descriptor);
+    throw failure("Unable to sync", file, lastError());
+  }
+
+  if (::close(descriptor) != 0) {
+    throw failure("Unable to close", file, lastError());
+  }
+}
+
+auto syncDirectory(path const& directory) noexcept(false) -> void {
+  auto const descriptor = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (descriptor < 0) {
+    throw failure("Unable to open directory", directory, lastError());
+  }
+
+  if (::fsync(descriptor) != 0) {
+    closePreservingError(descriptor);
+    throw failure("Unable to sync directory", directory, lastError());
+  }
+  ::close(descriptor);
+}
+#else
+auto writeSynced(path const& file, std::string_view contents) noexcept(false) -> void {
+  std::ofstream out(file, ios_base::binary | ios_base::trunc);
+  if (!out.write(contents.data(), static_cast<std::streamsize>(contents.size())).flush()) {
+    throw failure("Unable to write", file, std::make_error_code(std::io_errc::stream));
+  }
+}
+
+auto syncDirectory(path const&) noexcept -> void {
+  // empty on purpose
+}
+#endif
+} // namespace
+
+namespace age {
+auto AtomicFileWriter::write(path const& file, std::string_view contents) noexcept(false) -> void {
+  auto temporary = file;
+  temporary += ".tmp";
+
+  std::error_code ignored;
+  try {
+    writeSynced(temporary, contents);
+  } catch (...) {
+    std::filesystem::remove(temporary, ignored);
+    throw;
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temporary, file, error);
+  if (error) {
+    std::filesystem::remove(temporary, ignored);
+    throw failure("Unable to replace", file, error);
+  }
+
+  std::lock_guard const lock(_lock);
+  _directories.insert(file.parent_path());
+}
+
+auto AtomicFileWriter::commit() noexcept(false) -> void {
+  std::set<path> directories;
+  {
+    std::lock_guard const lock(_lock);
+    directories.swap(_directories);
+  }
+
+  for (auto const& directory : directories) {
+    syncDirectory(directory);
+  }
+}
+} // namespace age
@@ -0,0 +1,40 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#pragma once
+#include <filesystem>
+#include <mutex>
+#include <set>
+#include <string_view>
+
+namespace age {
+/// \brief Replaces files so that a crash leaves each one either as it was or fully written: the contents go to a
+/// temporary file next to the target, which is synced to disk and renamed over it. Renames only become durable once
+/// the directory holding them is synced, which commit does once per directory for every file written since the
+/// previous commit, instead of once per file. Without POSIX file syncing, files are still renamed into place, but not
+/// synced.
+///
+/// write may be called concurrently, for different files. Failures throw std::ios_base::failure and leave the target
+/// untouched.
+class AtomicFileWriter {
+public:
+  AtomicFileWriter() noexcept = default;
+  AtomicFileWriter(AtomicFileWriter const&) noexcept = delete;
+  AtomicFileWriter(AtomicFileWriter&&) noexcept = delete;
+  ~AtomicFileWriter() noexcept = default;
+
+  auto operator=(AtomicFileWriter const&) noexcept = delete;
+  auto operator=(AtomicFileWriter&&) noexcept = delete;
+
+  /// \brief Replaces the contents of the file, whose directory must exist.
+  auto write(std::filesystem::path const& path, std::string_view contents) noexcept(false) -> void;
+
+  /// \brief Syncs the directories of the files written since the previous commit.
+  auto commit() noexcept(false) -> void;
+
+private:
+  std::mutex _lock;
+  std::set<std::filesystem::path> _directories;
+};
+} // namespace age
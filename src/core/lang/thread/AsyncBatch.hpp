@@ -0,0 +1,211 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#pragma once
+#include <CDS/Function>
+#include <CDS/memory/SharedPointer>
+#include <CDS/meta/Base>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <lang/coro/Generator.hpp>
+#include <lang/generic/Concepts.hpp>
+#include <lang/thread/AsyncRunner.hpp>
+#include <lang/thread/Executor.hpp>
+#include <lang/thread/Future.hpp>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace age {
+namespace meta {
+/// \brief One batch: its arguments, results and progress. Shared by the AsyncBatch and the executor tasks working
+/// through it, since tasks may still be queued once every item is done.
+template <typename Result, typename... Args> class AsyncBatchState {
+public:
+  using Function = cds::Function<Result(Args...)>;
+
+  AsyncBatchState(Function const& function, std::vector<std::tuple<Args...>> arguments) noexcept(false) :
+      _fn(function), _arguments(std::move(arguments)), _results(_arguments.size()), _errors(_arguments.size()),
+      _order(_arguments.size()) {
+    for (auto& position : _order) {
+      position.store(notDone, std::memory_order_relaxed);
+    }
+  }
+
+  [[nodiscard]] auto size() const noexcept { return _arguments.size(); }
+
+  /// \brief Runs items until none is left to claim.
+  auto runAvailable() noexcept -> void {
+    while (runOne()) {
+      // empty on purpose
+    }
+  }
+
+  /// \brief Runs the item claimed next, if any is left.
+  auto runOne() noexcept -> bool {
+    auto const index = _next.fetch_add(1u, std::memory_order_relaxed);
+    if (index >= size()) {
+      return false;
+    }
+
+    try {
+      std::apply([this, index](auto&... args) { _results[index].awaitResult(_fn, args...); }, _arguments[index]);
+    } catch (...) {
+      _errors[index] = std::current_exception();
+    }
+
+    auto const position = _finished.fetch_add(1u, std::memory_order_acq_rel);
+    _order[position].store(index, std::memory_order_release);
+    _order[position].notify_all();
+    if (position + 1u == size()) {
+      _finished.notify_all();
+    }
+    return true;
+  }
+
+  /// \brief Helps with the remaining items, then waits for the ones still running elsewhere.
+  auto awaitAll() noexcept -> void {
+    runAvailable();
+    for (auto finished = _finished.load(std::memory_order_acquire); finished != size();
+         finished = _finished.load(std::memory_order_acquire)) {
+      _finished.wait(finished, std::memory_order_acquire);
+    }
+  }
+
+  /// \brief Index of the item that completed in the given position, helping with the remaining items meanwhile.
+  auto awaitCompletion(cds::Size position) noexcept -> cds::Size {
+    while (true) {
+      if (auto const index = _order[position].load(std::memory_order_acquire); index != notDone) {
+        return index;
+      }
+
+      if (!runOne()) {
+        _order[position].wait(notDone, std::memory_order_acquire);
+      }
+    }
+  }
+
+  /// \brief Once the item is done only. Rethrows the exception the item failed with.
+  auto rethrowIfFailed(cds::Size index) const noexcept(false) -> void {
+    if (_errors[index]) {
+      std::rethrow_exception(_errors[index]);
+    }
+  }
+
+  /// \brief Once every item is done only. Rethrows the exception of the first failed item, in argument order.
+  auto rethrowFirstFailure() const noexcept(false) -> void {
+    for (auto const& error : _errors) {
+      if (error) {
+        std::rethrow_exception(error);
+      }
+    }
+  }
+
+  /// \brief Once the item is done only.
+  [[nodiscard]] auto result(cds::Size index) noexcept -> auto& { return _results[index].value; }
+
+private:
+  static constexpr auto const notDone = static_cast<cds::Size>(-1);
+
+  Function _fn;
+  std::vector<std::tuple<Args...>> _arguments;
+  std::vector<AsyncResultContainer<Result>> _results;
+  std::vector<std::exception_ptr> _errors;
+  /// \brief Item indices, in completion order.
+  std::vector<std::atomic<cds::Size>> _order;
+  std::atomic<cds::Size> _next {0u};
+  std::atomic<cds::Size> _finished {0u};
+};
+} // namespace meta
+
+/// \brief Runs a function over a batch of argument tuples on an Executor, AsyncRunner style, for loops whose
+/// iterations are independent, such as loading or saving one settings file per group. At most parallelism tasks of
+/// the executor work through a batch, claiming items one by one; the thread awaiting it also runs items, so a batch
+/// awaited from an executor task completes even when every worker is busy. The function is called concurrently and
+/// must be safe to call so.
+///
+/// Results are available in argument order from await, or in completion order from completed. Exceptions thrown by
+/// the function are rethrown to the awaiting thread, once the other items are done.
+template <typename Result, typename... Args> class AsyncBatch {
+public:
+  using Function = cds::Function<Result(Args...)>;
+  using Arguments = std::tuple<Args...>;
+
+  AsyncBatch() noexcept = delete;
+  AsyncBatch(AsyncBatch const&) noexcept = delete;
+  AsyncBatch(AsyncBatch&&) noexcept = delete;
+  ~AsyncBatch() noexcept {
+    if (_state.get() != nullptr) {
+      _state->awaitAll();
+    }
+  }
+
+  auto operator=(AsyncBatch const&) noexcept = delete;
+  auto operator=(AsyncBatch&&) noexcept = delete;
+
+  /// \brief A parallelism of 0 uses every thread of the executor.
+  template <meta::concepts::DifferentFrom<AsyncBatch> F>
+  explicit(false) AsyncBatch(F&& function, Executor& executor = Executor::shared(),
+                             cds::Size parallelism = 0u) noexcept(false) :
+      _fn(std::forward<F>(function)), _executor(executor),
+      _parallelism(parallelism == 0u ? executor.threadCount() : parallelism) {}
+
+  /// \brief Starts running the function over each element of the range, every element being convertible to
+  /// std::tuple<Args...>. Waits for the previous batch first.
+  template <typename Range> auto trigger(Range const& argumentTuples) noexcept(false) -> void {
+    std::vector<Arguments> arguments;
+    for (auto const& element : argumentTuples) {
+      arguments.emplace_back(element);
+    }
+
+    if (_state.get() != nullptr) {
+      _state->awaitAll();
+    }
+
+    _state = cds::makeShared<meta::AsyncBatchState<Result, Args...>>(_fn, std::move(arguments));
+    for (auto tasks = std::min(_parallelism, _state->size()); tasks != 0u; --tasks) {
+      _executor.submit([state = _state] { state->runAvailable(); });
+    }
+  }
+
+  /// \brief Waits for the batch, returning the results in argument order, or nothing for void batches.
+  auto await() noexcept(false) {
+    if (_state.get() == nullptr) {
+      return meta::AllOf<Result>();
+    }
+
+    _state->awaitAll();
+    _state->rethrowFirstFailure();
+    if constexpr (!cds::meta::IsVoid<Result>::value) {
+      std::vector<Result> results;
+      results.reserve(_state->size());
+      for (cds::Size index = 0u; index < _state->size(); ++index) {
+        results.push_back(std::move(_state->result(index)));
+      }
+      return results;
+    }
+  }
+
+  /// \brief Yields the results as items complete. An item that failed rethrows its exception when its turn comes.
+  auto completed() noexcept(false) -> Generator<Result>
+    requires(!cds::meta::IsVoid<Result>::value)
+  {
+    auto const state = _state;
+    for (cds::Size position = 0u; state.get() != nullptr && position < state->size(); ++position) {
+      auto const index = state->awaitCompletion(position);
+      state->rethrowIfFailed(index);
+      co_yield std::move(state->result(index));
+    }
+  }
+
+  [[nodiscard]] auto parallelism() const noexcept { return _parallelism; }
+
+private:
+  Function _fn;
+  Executor& _executor;
+  cds::Size _parallelism;
+  cds::SharedPointer<meta::AsyncBatchState<Result, Args...>> _state;
+};
+} // namespace age
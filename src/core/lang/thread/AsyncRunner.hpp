@@ -6,16 +6,16 @@
 #include <CDS/Function>
 #include <CDS/memory/UniquePointer>
 #include <CDS/meta/Base>
-#include <CDS/threading/Thread>
 #include <atomic>
-#include <condition_variable>
 #include <lang/generic/Concepts.hpp>
-#include <mutex>
-#include <tuple>
+#include <lang/thread/Executor.hpp>
+#include <thread>
 
 namespace age {
 namespace meta {
 template <typename T, typename R, bool = cds::meta::IsVoid<R>::value> class AwaitWrapper {};
+template <typename T> class FutureState;
+template <typename R, typename... A> class AsyncBatchState;
 
 template <typename T, bool = cds::meta::IsVoid<T>::value> class AsyncResultContainer {
 public:
@@ -28,6 +28,8 @@ public:
 
 private:
   template <typename, typename, bool> friend class AwaitWrapper;
+  template <typename> friend class FutureState;
+  template <typename, typename...> friend class AsyncBatchState;
   T value;
 };
 
@@ -45,6 +47,9 @@ public:
 };
 } // namespace meta
 
+/// \brief Runs a function on an Executor, one call at a time, keeping its result until awaited. Completion is an atomic
+/// state waited on with std::atomic::wait: triggering only submits the task, and the worker finishing it wakes the
+/// awaiting threads with a single notify.
 template <typename Result, typename... Args> class AsyncRunner :
     public meta::AwaitWrapper<AsyncRunner<Result, Args...>, Result> {
 public:
@@ -53,78 +58,71 @@ public:
   AsyncRunner() noexcept = delete;
   AsyncRunner(AsyncRunner const&) noexcept = delete;
   AsyncRunner(AsyncRunner&&) noexcept = delete;
-  ~AsyncRunner() noexcept { join(); }
+  ~AsyncRunner() noexcept { settle(); }
 
   auto operator=(AsyncRunner const&) noexcept = delete;
   auto operator=(AsyncRunner&&) noexcept = delete;
 
-  template <meta::concepts::DifferentFrom<AsyncRunner> F> explicit(false) AsyncRunner(F&& function) noexcept(false) :
-      _fn(std::forward<F>(function)) {}
+  template <meta::concepts::DifferentFrom<AsyncRunner> F>
+  explicit(false) AsyncRunner(F&& function, Executor& executor = Executor::shared()) noexcept(false) :
+      _fn(std::forward<F>(function)), _executor(executor) {}
 
+  /// \brief Runs the function with the given arguments, once the previous run, if any, has finished.
   template <typename... A> auto trigger(A&&... args) noexcept(false);
-  [[nodiscard]] auto notStarted() const noexcept { return !std::get<2>(_sync); }
+  [[nodiscard]] auto notStarted() const noexcept { return _state.load(std::memory_order_acquire) == Idle; }
 
 private:
   friend class meta::AwaitWrapper<AsyncRunner<Result, Args...>, Result>;
+
+  enum State : cds::uint32 {
+    Idle,
+    Running,
+    /// \brief The result is set, the worker is still waking the awaiting threads.
+    Notifying,
+    Done
+  };
+
   auto join() noexcept;
-  auto reset();
+  auto settle() noexcept;
 
   Function _fn {nullptr};
   [[no_unique_address]] meta::AsyncResultContainer<Result> _result;
-  cds::UniquePointer<cds::Thread> _executer {nullptr};
-  std::tuple<std::mutex, std::condition_variable, bool, bool> _sync;
-  std::atomic_flag _started;
-  std::atomic_flag _ended;
+  Executor& _executor;
+  std::atomic<cds::uint32> _state {Idle};
 };
 
-template <typename Result, typename... Args> auto AsyncRunner<Result, Args...>::reset() {
-  _ended.clear(std::memory_order_release);
-  std::get<2>(_sync) = false;
-  std::get<3>(_sync) = false;
-}
-
 template <typename Result, typename... Args> auto AsyncRunner<Result, Args...>::join() noexcept {
-  if (!_started.test(std::memory_order_acquire)) {
-    return;
+  for (auto state = _state.load(std::memory_order_acquire); state == Running;
+       state = _state.load(std::memory_order_acquire)) {
+    _state.wait(state, std::memory_order_acquire);
   }
+}
 
-  auto& [mutex, condition, startStatus, endStatus] = _sync;
-  auto prepareStop = [&mutex, &condition, &endStatus] {
-    std::unique_lock lock(mutex);
-    condition.wait(lock, [&endStatus] { return endStatus; });
-  };
-
-  if (_ended.test_and_set()) {
-    return;
+template <typename Result, typename... Args> auto AsyncRunner<Result, Args...>::settle() noexcept {
+  join();
+  // The result is visible from Notifying on, but the worker still calls notify_all on _state: the runner must not be
+  // reused or destroyed before it is done. This window is a few instructions long, so yielding is enough.
+  while (_state.load(std::memory_order_acquire) == Notifying) {
+    std::this_thread::yield();
   }
-
-  prepareStop();
-  _executer->join();
-  _executer.reset();
 }
 
 template <typename Result, typename... Args> template <typename... A>
 auto AsyncRunner<Result, Args...>::trigger(A&&... args) noexcept(false) {
-  reset();
-  _executer = new cds::Runnable([this, args...]() mutable {
-    auto& [mutex, condition, startStatus, endStatus] = _sync;
-    std::unique_lock lock(mutex);
-    condition.wait(lock, [&startStatus] { return startStatus; });
-    _result.awaitResult(_fn, args...);
-    endStatus = true;
-    lock.unlock();
-    condition.notify_one();
-  });
-  (void) _started.test_and_set(std::memory_order_release);
-  _executer->start();
-
-  auto& [mutex, condition, startStatus, endStatus] = _sync;
-  auto prepareNotify = [&mutex, &startStatus] {
-    std::lock_guard _(mutex);
-    startStatus = true;
-  };
-
-  prepareNotify();
-  condition.notify_one();
+  settle();
+  _state.store(Running, std::memory_order_relaxed);
+
+  // Submitting publishes the Running state and the arguments to the worker
+  try {
+    _executor.submit([this, args...]() mutable {
+      _result.awaitResult(_fn, args...);
+      _state.store(Notifying, std::memory_order_release);
+      _state.notify_all();
+      _state.store(Done, std::memory_order_release);
+    });
+  } catch (...) {
+    _state.store(Idle, std::memory_order_release);
+    throw;
+  }
 }
 } // namespace age
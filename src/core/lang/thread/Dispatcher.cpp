@@ -0,0 +1,81 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include "Dispatcher.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+namespace age {
+auto Dispatcher::submit(Task task) noexcept(false) -> void {
+  Task wakeup {nullptr};
+  {
+    std::lock_guard lock(_mutex);
+    // Only the first task of a batch wakes the owner, the drain it schedules runs the whole batch
+    if (_tasks.empty()) {
+      wakeup = _wakeup;
+    }
+    _tasks.push_back(std::move(task));
+  }
+
+  if (wakeup) {
+    wakeup();
+  }
+}
+
+auto Dispatcher::drain() noexcept(false) -> cds::Size {
+  std::vector<Task> tasks;
+  {
+    std::lock_guard lock(_mutex);
+    tasks.swap(_tasks);
+  }
+
+  auto run = cds::Size {0u};
+  try {
+    for (; run < tasks.size(); ++run) {
+      tasks[run]();
+    }
+  } catch (...) {
+    // The tasks after the throwing one may be suspended coroutines, which would never resume if dropped. They run
+    // first in the next drain, scheduled here unless a submit since already did
+    Task wakeup {nullptr};
+    if (run + 1u < tasks.size()) {
+      std::lock_guard lock(_mutex);
+      if (_tasks.empty()) {
+        wakeup = _wakeup;
+      }
+      _tasks.insert(_tasks.begin(), std::make_move_iterator(tasks.begin() + static_cast<std::ptrdiff_t>(run + 1u)),
+                    std::make_move_iterator(tasks.end()));
+    }
+
+    if (wakeup) {
+      wakeup();
+    }
+    throw;
+  }
+  return tasks.size();
+}
+
+auto Dispatcher::setWakeup(Task wakeup) noexcept(false) -> void {
+  Task pendingWakeup {nullptr};
+  {
+    std::lock_guard lock(_mutex);
+    _wakeup = std::move(wakeup);
+    // Tasks submitted before the owner was ready still get their drain
+    if (!_tasks.empty()) {
+      pendingWakeup = _wakeup;
+    }
+  }
+
+  if (pendingWakeup) {
+    pendingWakeup();
+  }
+}
+
+auto Dispatcher::mainThread() noexcept(false) -> Dispatcher& {
+  static auto* const pDispatcher = new Dispatcher();
+  return *pDispatcher;
+}
+} // namespace age
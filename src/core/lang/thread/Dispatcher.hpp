@@ -0,0 +1,44 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#pragma once
+#include <CDS/Function>
+#include <mutex>
+#include <vector>
+
+namespace age {
+/// \brief Queue of tasks run by the one thread owning it, such as the Qt main thread. Any thread may submit; the owner
+/// runs the queued tasks with drain. The owner installs a wakeup, called when the queue stops being empty, to schedule
+/// that drain from its own event loop, e.g. through a queued QMetaObject::invokeMethod. Core code stays free of Qt.
+class Dispatcher {
+public:
+  using Task = cds::Function<void()>;
+
+  Dispatcher() noexcept = default;
+  Dispatcher(Dispatcher const&) = delete;
+  Dispatcher(Dispatcher&&) = delete;
+  ~Dispatcher() noexcept = default;
+
+  auto operator=(Dispatcher const&) = delete;
+  auto operator=(Dispatcher&&) = delete;
+
+  auto submit(Task task) noexcept(false) -> void;
+
+  /// \brief Owner only. Runs the tasks queued so far; tasks they submit wait for the next drain, so that a task
+  /// resubmitting itself cannot starve the event loop. Returns the number of tasks run. A throwing task propagates its
+  /// exception, leaving the tasks after it queued for the next drain.
+  auto drain() noexcept(false) -> cds::Size;
+
+  /// \brief Replaces the wakeup. Called outside of the queue lock, possibly from any submitting thread.
+  auto setWakeup(Task wakeup) noexcept(false) -> void;
+
+  /// \brief Dispatcher of the application main thread, drained by the Qt event loop in the visualizer.
+  static auto mainThread() noexcept(false) -> Dispatcher&;
+
+private:
+  std::mutex _mutex;
+  std::vector<Task> _tasks;
+  Task _wakeup {nullptr};
+};
+} // namespace age
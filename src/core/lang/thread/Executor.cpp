@@ -0,0 +1,62 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include "Executor.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+namespace age {
+Executor::Executor(cds::Size threadCount) noexcept(false) {
+  auto const count = std::max(threadCount, cds::Size {1u});
+  _workers.reserve(count);
+  while (_workers.size() < count) {
+    _workers.emplace_back(new cds::Runnable([this] { run(); }))->start();
+  }
+}
+
+Executor::~Executor() noexcept {
+  {
+    std::lock_guard lock(_mutex);
+    _stopping = true;
+  }
+  _available.notify_all();
+  for (auto& worker : _workers) {
+    worker->join();
+  }
+}
+
+auto Executor::submit(Task task) noexcept(false) -> void {
+  {
+    std::lock_guard lock(_mutex);
+    _tasks.push_back(std::move(task));
+  }
+  _available.notify_one();
+}
+
+auto Executor::run() noexcept -> void {
+  while (true) {
+    std::unique_lock lock(_mutex);
+    _available.wait(lock, [this] { return _stopping || !_tasks.empty(); });
+    if (_tasks.empty()) {
+      return;
+    }
+
+    auto task = std::move(_tasks.front());
+    _tasks.pop_front();
+    lock.unlock();
+    task();
+  }
+}
+
+auto Executor::shared() noexcept(false) -> Executor& {
+  static auto* const pExecutor = new Executor();
+  return *pExecutor;
+}
+
+auto Executor::defaultThreadCount() noexcept -> cds::Size {
+  return std::max(std::thread::hardware_concurrency(), 2u);
+}
+} // namespace age
@@ -0,0 +1,48 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#pragma once
+#include <CDS/Function>
+#include <CDS/memory/UniquePointer>
+#include <CDS/threading/Thread>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace age {
+/// \brief Fixed set of worker threads running submitted tasks in submission order. Threads are started once, so
+/// submitting a task costs a queue push instead of a thread creation.
+class Executor {
+public:
+  using Task = cds::Function<void()>;
+
+  /// \brief Starts the given number of workers, at least one.
+  explicit Executor(cds::Size threadCount = defaultThreadCount()) noexcept(false);
+  Executor(Executor const&) = delete;
+  Executor(Executor&&) = delete;
+  /// \brief Runs every task already submitted, then joins the workers.
+  ~Executor() noexcept;
+
+  auto operator=(Executor const&) = delete;
+  auto operator=(Executor&&) = delete;
+
+  auto submit(Task task) noexcept(false) -> void;
+  [[nodiscard]] auto threadCount() const noexcept { return _workers.size(); }
+
+  /// \brief Process-wide executor, sized to the hardware. Never destroyed, so tasks submitted or awaited during
+  /// static destruction still run.
+  static auto shared() noexcept(false) -> Executor&;
+  static auto defaultThreadCount() noexcept -> cds::Size;
+
+private:
+  auto run() noexcept -> void;
+
+  std::vector<cds::UniquePointer<cds::Thread>> _workers;
+  std::deque<Task> _tasks;
+  std::mutex _mutex;
+  std::condition_variable _available;
+  bool _stopping {false};
+};
+} // namespace age
@@ -0,0 +1,349 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#pragma once
+#include <CDS/Function>
+#include <CDS/memory/SharedPointer>
+#include <CDS/meta/Base>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <future>
+#include <lang/thread/AsyncRunner.hpp>
+#include <lang/thread/Executor.hpp>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace age {
+template <typename T> class Future;
+template <typename T> class Promise;
+
+namespace meta {
+template <typename T> struct FutureTypes {
+  using Value = T const&;
+  using All = std::vector<T>;
+};
+
+template <> struct FutureTypes<void> {
+  using Value = void;
+  using All = void;
+};
+
+template <typename T> using FutureValue = typename FutureTypes<T>::Value;
+template <typename T> using AllOf = typename FutureTypes<T>::All;
+
+template <typename T> struct Unwrapped {
+  using Type = T;
+};
+
+template <typename T> struct Unwrapped<Future<T>> {
+  using Type = T;
+};
+
+template <typename T> inline constexpr bool isFuture = false;
+template <typename T> inline constexpr bool isFuture<Future<T>> = true;
+
+template <typename T, typename F> struct ContinuationOf {
+  using Type = std::invoke_result_t<F&, T const&>;
+};
+
+template <typename F> struct ContinuationOf<void, F> {
+  using Type = std::invoke_result_t<F&>;
+};
+
+/// \brief State shared by a Promise and its futures. Holds the result in an AsyncResultContainer, or the exception
+/// that replaced it, and the continuations to run once either is set. Only the first result set is kept.
+template <typename T> class FutureState {
+public:
+  using Continuation = cds::Function<void()>;
+
+  /// \brief Keeps the result of fn, or the exception it threw. Returns false if a result was already set.
+  template <typename F, typename... A> auto fulfil(F&& fn, A&&... args) noexcept -> bool {
+    if (!claim()) {
+      return false;
+    }
+
+    try {
+      _result.awaitResult(std::forward<F>(fn), std::forward<A>(args)...);
+    } catch (...) {
+      _exception = std::current_exception();
+    }
+    complete();
+    return true;
+  }
+
+  auto fail(std::exception_ptr exception) noexcept -> bool {
+    if (!claim()) {
+      return false;
+    }
+
+    _exception = std::move(exception);
+    complete();
+    return true;
+  }
+
+  /// \brief Sets the result, value or exception, of another ready state.
+  auto forward(FutureState& from) noexcept -> bool {
+    if (from._exception) {
+      return fail(from._exception);
+    }
+
+    if constexpr (cds::meta::IsVoid<T>::value) {
+      return fulfil([] {});
+    } else {
+      return fulfil([&from]() -> T const& { return from._result.value; });
+    }
+  }
+
+  /// \brief Runs the continuation once the result is set: right away if it already is, otherwise on the thread
+  /// setting it.
+  auto onReady(Continuation continuation) noexcept(false) -> void {
+    {
+      std::lock_guard lock(_lock);
+      if (!_ready) {
+        _continuations.push_back(std::move(continuation));
+        return;
+      }
+    }
+    continuation();
+  }
+
+  [[nodiscard]] auto ready() noexcept -> bool {
+    std::lock_guard lock(_lock);
+    return _ready;
+  }
+
+  auto wait() noexcept -> void {
+    std::unique_lock lock(_lock);
+    _condition.wait(lock, [this] { return _ready; });
+  }
+
+  /// \brief Waits for the result, rethrowing the exception that replaced it.
+  auto get() noexcept(false) -> FutureValue<T> {
+    wait();
+    if (_exception) {
+      std::rethrow_exception(_exception);
+    }
+
+    if constexpr (!cds::meta::IsVoid<T>::value) {
+      return _result.value;
+    }
+  }
+
+  /// \brief Once ready only.
+  [[nodiscard]] auto exception() const noexcept -> std::exception_ptr const& { return _exception; }
+
+  /// \brief Once ready only. Calls fn with the value, or with no argument for void states.
+  template <typename F> auto apply(F& fn) const noexcept(false) -> decltype(auto) {
+    if constexpr (cds::meta::IsVoid<T>::value) {
+      return fn();
+    } else {
+      return fn(std::as_const(_result.value));
+    }
+  }
+
+private:
+  auto claim() noexcept -> bool {
+    std::lock_guard lock(_lock);
+    return !std::exchange(_claimed, true);
+  }
+
+  auto complete() noexcept -> void {
+    std::vector<Continuation> continuations;
+    {
+      std::lock_guard lock(_lock);
+      _ready = true;
+      continuations.swap(_continuations);
+    }
+
+    _condition.notify_all();
+    for (auto& continuation : continuations) {
+      continuation();
+    }
+  }
+
+  std::mutex _lock;
+  std::condition_variable _condition;
+  bool _claimed {false};
+  bool _ready {false};
+  [[no_unique_address]] AsyncResultContainer<T> _result;
+  std::exception_ptr _exception;
+  std::vector<Continuation> _continuations;
+};
+
+struct FutureAccess {
+  template <typename T> static auto state(Future<T> const& future) noexcept -> auto const& { return future._state; }
+  template <typename T> static auto make(cds::SharedPointer<FutureState<T>> state) noexcept {
+    return Future<T>(std::move(state));
+  }
+};
+} // namespace meta
+
+/// \brief Result of an asynchronous computation, set through a Promise. Futures are copyable handles to the same
+/// result, so several consumers can wait for it, read it or chain continuations on it. T must be default
+/// constructible, as it is held in the AsyncResultContainer used by AsyncRunner.
+template <typename T> class Future {
+public:
+  Future() noexcept = default;
+
+  /// \brief False for default constructed futures, which have no result to wait for.
+  [[nodiscard]] auto valid() const noexcept { return _state.get() != nullptr; }
+  [[nodiscard]] auto ready() const noexcept { return _state->ready(); }
+  auto wait() const noexcept -> void { _state->wait(); }
+
+  /// \brief Waits for the result. Rethrows the exception the computation failed with.
+  [[nodiscard]] auto get() const noexcept(false) -> meta::FutureValue<T> { return _state->get(); }
+
+  /// \brief Runs continuation(value), or continuation() for Future<void>, on the executor once the result is set,
+  /// without blocking the caller. If the computation failed, the continuation is skipped and the returned future fails
+  /// with the same exception, as it does if the continuation throws. A continuation returning a Future is unwrapped:
+  /// the returned future is set once that one is.
+  template <typename F> auto then(F&& continuation, Executor& executor = Executor::shared()) const noexcept(false);
+
+private:
+  friend struct meta::FutureAccess;
+  friend class Promise<T>;
+
+  explicit Future(cds::SharedPointer<meta::FutureState<T>> state) noexcept : _state(std::move(state)) {}
+
+  cds::SharedPointer<meta::FutureState<T>> _state;
+};
+
+/// \brief Producer side of a Future. Destroying a promise that was never set fails its futures with
+/// std::future_errc::broken_promise, so waiting on them cannot hang.
+template <typename T> class Promise {
+public:
+  Promise() noexcept(false) : _state(cds::makeShared<meta::FutureState<T>>()) {}
+  Promise(Promise const&) = delete;
+  Promise(Promise&&) noexcept = default;
+  ~Promise() noexcept {
+    if (_state.get() != nullptr) {
+      (void) _state->fail(std::make_exception_ptr(std::future_error(std::future_errc::broken_promise)));
+    }
+  }
+
+  auto operator=(Promise const&) = delete;
+  auto operator=(Promise&&) = delete;
+
+  [[nodiscard]] auto future() const noexcept { return Future<T>(_state); }
+
+  /// \brief Sets the value, built from the arguments. Returns false if a result was already set.
+  template <typename... V> auto setValue(V&&... value) noexcept -> bool {
+    return _state->fulfil([&value...]() -> T { return T(std::forward<V>(value)...); });
+  }
+
+  auto setException(std::exception_ptr exception) noexcept -> bool { return _state->fail(std::move(exception)); }
+
+  /// \brief Sets the result of fn, or the exception it threw.
+  template <typename F, typename... A> auto setResultOf(F&& fn, A&&... args) noexcept -> bool {
+    return _state->fulfil(std::forward<F>(fn), std::forward<A>(args)...);
+  }
+
+private:
+  cds::SharedPointer<meta::FutureState<T>> _state;
+};
+
+template <typename T> template <typename F>
+auto Future<T>::then(F&& continuation, Executor& executor) const noexcept(false) {
+  using Result = typename meta::ContinuationOf<T, cds::meta::Decay<F>>::Type;
+  using Next = typename meta::Unwrapped<Result>::Type;
+
+  auto next = cds::makeShared<meta::FutureState<Next>>();
+  _state->onReady([state = _state, next, fn = std::forward<F>(continuation), pExecutor = &executor]() mutable {
+    pExecutor->submit([state = std::move(state), next = std::move(next), fn = std::move(fn)]() mutable {
+      if (state->exception()) {
+        (void) next->fail(state->exception());
+      } else if constexpr (meta::isFuture<Result>) {
+        try {
+          auto const inner = meta::FutureAccess::state(state->apply(fn));
+          // The inner state runs this while setting itself, so it outlives the call
+          inner->onReady([pInner = inner.get(), next] { (void) next->forward(*pInner); });
+        } catch (...) {
+          (void) next->fail(std::current_exception());
+        }
+      } else {
+        (void) next->fulfil([&state, &fn]() -> Result { return state->apply(fn); });
+      }
+    });
+  });
+  return meta::FutureAccess::make(std::move(next));
+}
+
+/// \brief Runs fn on the executor, returning the future of its result.
+template <typename F> auto runAsync(F&& fn, Executor& executor = Executor::shared()) noexcept(false) {
+  auto state = cds::makeShared<meta::FutureState<std::invoke_result_t<cds::meta::Decay<F>&>>>();
+  executor.submit([state, function = std::forward<F>(fn)]() mutable { (void) state->fulfil(function); });
+  return meta::FutureAccess::make(std::move(state));
+}
+
+/// \brief Future set once every given future is: with their values in order, or with the exception of the first
+/// failed one, in order. An empty set yields a ready future.
+template <typename T> auto whenAll(std::vector<Future<T>> futures) noexcept(false) -> Future<meta::AllOf<T>> {
+  struct Join {
+    Join(std::vector<Future<T>> futures, cds::Size count, cds::SharedPointer<meta::FutureState<meta::AllOf<T>>> next) :
+        futures(std::move(futures)), remaining(count), next(std::move(next)) {}
+
+    std::vector<Future<T>> futures;
+    std::atomic<cds::Size> remaining;
+    cds::SharedPointer<meta::FutureState<meta::AllOf<T>>> next;
+
+    auto finish() noexcept -> void {
+      for (auto const& future : futures) {
+        if (auto const& exception = meta::FutureAccess::state(future)->exception(); exception) {
+          (void) next->fail(exception);
+          return;
+        }
+      }
+
+      if constexpr (cds::meta::IsVoid<T>::value) {
+        (void) next->fulfil([] {});
+      } else {
+        (void) next->fulfil([this] {
+          std::vector<T> values;
+          values.reserve(futures.size());
+          for (auto const& future : futures) {
+            values.push_back(future.get());
+          }
+          return values;
+        });
+      }
+    }
+  };
+
+  auto next = cds::makeShared<meta::FutureState<meta::AllOf<T>>>();
+  if (futures.empty()) {
+    (void) next->fulfil([] { return meta::AllOf<T>(); });
+    return meta::FutureAccess::make(std::move(next));
+  }
+
+  auto const count = futures.size();
+  auto join = cds::makeShared<Join>(std::move(futures), count, next);
+  for (auto const& future : join->futures) {
+    meta::FutureAccess::state(future)->onReady([join] {
+      if (join->remaining.fetch_sub(1u, std::memory_order_acq_rel) == 1u) {
+        join->finish();
+      }
+    });
+  }
+  return meta::FutureAccess::make(std::move(next));
+}
+
+/// \brief Future set with the index of the first of the given futures to be set, whether with a value or an exception.
+/// An empty set yields a future failed with std::future_errc::no_state.
+template <typename T> auto whenAny(std::vector<Future<T>> const& futures) noexcept(false) -> Future<cds::Size> {
+  auto next = cds::makeShared<meta::FutureState<cds::Size>>();
+  if (futures.empty()) {
+    (void) next->fail(std::make_exception_ptr(std::future_error(std::future_errc::no_state)));
+  }
+
+  for (cds::Size index = 0u; index < futures.size(); ++index) {
+    meta::FutureAccess::state(futures[index])->onReady([next, index] {
+      (void) next->fulfil([index] { return index; });
+    });
+  }
+  return meta::FutureAccess::make(std::move(next));
+}
+} // namespace age
@@ -0,0 +1,166 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include "Scheduler.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace {
+struct WorkerContext {
+  age::Scheduler const* pScheduler {nullptr};
+  cds::Size index {0u};
+};
+
+thread_local WorkerContext currentContext;
+} // namespace
+
+namespace age {
+Scheduler::Scheduler(cds::Size threadCount) noexcept(false) {
+  threadCount = std::max(threadCount, cds::Size {1u});
+  _workers.reserve(threadCount);
+  for (cds::Size index = 0u; index < threadCount; ++index) {
+    _workers.emplace_back(cds::makeUnique<Worker>());
+  }
+
+  // Every deque exists before any worker may try to steal from it
+  for (cds::Size index = 0u; index < threadCount; ++index) {
+    auto& thread = _workers[index]->thread;
+    thread = new cds::Runnable([this, index] { run(index); });
+    thread->start();
+  }
+}
+
+Scheduler::~Scheduler() noexcept {
+  join();
+  _stopping.store(true, std::memory_order_release);
+  _wakeups.fetch_add(1u, std::memory_order_release);
+  _wakeups.notify_all();
+  for (auto& worker : _workers) {
+    worker->thread->join();
+  }
+}
+
+auto Scheduler::join() noexcept -> void { helpUntilDone(_pending); }
+
+auto Scheduler::currentWorker() const noexcept -> cds::Size {
+  return currentContext.pScheduler == this ? currentContext.index : notAWorker;
+}
+
+auto Scheduler::submit(Task* pTask) noexcept(false) -> void {
+  _pending.fetch_add(1u, std::memory_order_relaxed);
+  if (auto const self = currentWorker(); self != notAWorker) {
+    _workers[self]->tasks.push(pTask);
+  } else {
+    std::lock_guard lock(_injectionLock);
+    _injection.push_back(pTask);
+    _injected.fetch_add(1u, std::memory_order_release);
+  }
+
+  // Pairs with the fence of a worker going to sleep: either it sees this task, or this sees it sleeping
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (_sleeping.load(std::memory_order_relaxed) != 0u) {
+    _wakeups.fetch_add(1u, std::memory_order_release);
+    _wakeups.notify_one();
+  }
+}
+
+auto Scheduler::execute(Task* pTask) noexcept -> void {
+  pTask->function();
+  auto* const pGroup = pTask->pGroup;
+  delete pTask;
+
+  if (pGroup != nullptr) {
+    pGroup->_notifying.fetch_add(1u, std::memory_order_relaxed);
+    if (pGroup->_pending.fetch_sub(1u, std::memory_order_acq_rel) == 1u) {
+      pGroup->_pending.notify_all();
+    }
+    pGroup->_notifying.fetch_sub(1u, std::memory_order_release);
+  }
+  if (_pending.fetch_sub(1u, std::memory_order_acq_rel) == 1u) {
+    _pending.notify_all();
+  }
+}
+
+auto Scheduler::findTask(cds::Size self) noexcept -> Task* {
+  if (self != notAWorker) {
+    if (auto* pTask = _workers[self]->tasks.pop(); pTask != nullptr) {
+      return pTask;
+    }
+  }
+
+  if (_injected.load(std::memory_order_acquire) != 0u) {
+    std::lock_guard lock(_injectionLock);
+    if (!_injection.empty()) {
+      auto* pTask = _injection.front();
+      _injection.pop_front();
+      _injected.fetch_sub(1u, std::memory_order_relaxed);
+      return pTask;
+    }
+  }
+
+  // Start next to the thief, so that thieves spread over the victims
+  auto const count = _workers.size();
+  auto const start = self == notAWorker ? 0u : self + 1u;
+  for (cds::Size offset = 0u; offset < count; ++offset) {
+    auto const victim = (start + offset) % count;
+    if (victim == self) {
+      continue;
+    }
+
+    if (auto* pTask = _workers[victim]->tasks.steal(); pTask != nullptr) {
+      return pTask;
+    }
+  }
+  return nullptr;
+}
+
+auto Scheduler::helpUntilDone(std::atomic<cds::Size> const& pending) noexcept -> void {
+  auto const self = currentWorker();
+  while (true) {
+    auto const remaining = pending.load(std::memory_order_acquire);
+    if (remaining == 0u) {
+      return;
+    }
+
+    if (self == notAWorker) {
+      pending.wait(remaining, std::memory_order_acquire);
+    } else if (auto* pTask = findTask(self); pTask != nullptr) {
+      execute(pTask);
+    } else {
+      // The awaited tasks run on other workers. Blocking here could starve tasks only this worker would take.
+      std::this_thread::yield();
+    }
+  }
+}
+
+auto Scheduler::run(cds::Size index) noexcept -> void {
+  currentContext = {this, index};
+  while (true) {
+    if (auto* pTask = findTask(index); pTask != nullptr) {
+      execute(pTask);
+      continue;
+    }
+
+    auto const wakeups = _wakeups.load(std::memory_order_acquire);
+    _sleeping.fetch_add(1u, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // Checked again after announcing the sleep, so a task submitted meanwhile is not missed
+    if (auto* pTask = findTask(index); pTask != nullptr) {
+      _sleeping.fetch_sub(1u, std::memory_order_relaxed);
+      execute(pTask);
+      continue;
+    }
+
+    if (_stopping.load(std::memory_order_acquire)) {
+      _sleeping.fetch_sub(1u, std::memory_order_relaxed);
+      return;
+    }
+
+    _wakeups.wait(wakeups, std::memory_order_acquire);
+    _sleeping.fetch_sub(1u, std::memory_order_relaxed);
+  }
+}
+} // namespace age
@@ -0,0 +1,138 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#pragma once
+#include <CDS/Function>
+#include <CDS/memory/UniquePointer>
+#include <CDS/threading/Thread>
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <lang/thread/Executor.hpp>
+#include <lang/thread/WorkStealingDeque.hpp>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace age {
+class TaskGroup;
+
+/// \brief Work-stealing task scheduler. Every worker owns a Chase-Lev deque: tasks spawned by a worker go to its own
+/// deque and are run newest first, idle workers steal the oldest tasks of the others. Tasks spawned from other threads
+/// go through a shared injection queue. Workers with nothing to run or steal park until a task is spawned.
+///
+/// Tasks must not throw. Waiting for tasks, in join or TaskGroup::join, runs other tasks meanwhile when called from a
+/// worker, so tasks may spawn and join nested tasks without blocking a worker.
+class Scheduler {
+public:
+  explicit Scheduler(cds::Size threadCount = Executor::defaultThreadCount()) noexcept(false);
+  Scheduler(Scheduler const&) = delete;
+  Scheduler(Scheduler&&) = delete;
+  /// \brief Waits for every spawned task, then stops the workers.
+  ~Scheduler() noexcept;
+
+  auto operator=(Scheduler const&) = delete;
+  auto operator=(Scheduler&&) = delete;
+
+  /// \brief Runs a task asynchronously. join waits for it, along with every other task of the scheduler.
+  template <typename F> auto spawn(F&& function) noexcept(false) -> void {
+    submit(new Task {std::forward<F>(function), nullptr});
+  }
+
+  /// \brief Waits until every task spawned so far, and every task they spawned, has finished.
+  auto join() noexcept -> void;
+
+  [[nodiscard]] auto threadCount() const noexcept { return _workers.size(); }
+
+private:
+  friend class TaskGroup;
+
+  struct Task {
+    cds::Function<void()> function;
+    TaskGroup* pGroup;
+  };
+
+  struct Worker {
+    meta::WorkStealingDeque<Task*> tasks;
+    cds::UniquePointer<cds::Thread> thread;
+  };
+
+  auto submit(Task* pTask) noexcept(false) -> void;
+  auto execute(Task* pTask) noexcept -> void;
+  auto findTask(cds::Size self) noexcept -> Task*;
+  [[nodiscard]] auto currentWorker() const noexcept -> cds::Size;
+  /// \brief Runs tasks until the counter reaches zero. Threads other than the workers block instead.
+  auto helpUntilDone(std::atomic<cds::Size> const& pending) noexcept -> void;
+  auto run(cds::Size index) noexcept -> void;
+
+  static constexpr auto const notAWorker = static_cast<cds::Size>(-1);
+
+  std::vector<cds::UniquePointer<Worker>> _workers;
+  std::mutex _injectionLock;
+  std::deque<Task*> _injection;
+  std::atomic<cds::Size> _injected {0u};
+  std::atomic<cds::Size> _pending {0u};
+  std::atomic<cds::uint32> _wakeups {0u};
+  std::atomic<cds::uint32> _sleeping {0u};
+  std::atomic<bool> _stopping {false};
+};
+
+/// \brief Set of tasks that can be waited for together, e.g. the two halves of a divide and conquer step.
+class TaskGroup {
+public:
+  explicit TaskGroup(Scheduler& scheduler) noexcept : _scheduler(scheduler) {}
+  TaskGroup(TaskGroup const&) = delete;
+  TaskGroup(TaskGroup&&) = delete;
+  ~TaskGroup() noexcept { join(); }
+
+  auto operator=(TaskGroup const&) = delete;
+  auto operator=(TaskGroup&&) = delete;
+
+  template <typename F> auto spawn(F&& function) noexcept(false) -> void {
+    _pending.fetch_add(1u, std::memory_order_relaxed);
+    _scheduler.submit(new Scheduler::Task {std::forward<F>(function), this});
+  }
+
+  /// \brief Waits for every task spawned in this group.
+  auto join() noexcept -> void {
+    _scheduler.helpUntilDone(_pending);
+    // The task finishing the group may still be waking its joiners: the group must not be destroyed before it is done.
+    // This window is a few instructions long, so yielding is enough.
+    while (_notifying.load(std::memory_order_acquire) != 0u) {
+      std::this_thread::yield();
+    }
+  }
+
+private:
+  friend class Scheduler;
+
+  Scheduler& _scheduler;
+  std::atomic<cds::Size> _pending {0u};
+  /// \brief Finished tasks still accessing the group, raised before _pending is decremented.
+  std::atomic<cds::Size> _notifying {0u};
+};
+
+/// \brief Calls body(index) for every index in [begin, end), splitting the range in halves down to grain-sized
+/// chunks, so idle workers steal the largest remaining pieces. A grain below one is taken as one.
+template <typename Index, typename Body>
+auto parallelFor(Scheduler& scheduler, Index begin, Index end, Index grain, Body const& body) noexcept(false)
+    -> void {
+  TaskGroup group(scheduler);
+  auto const chunk = std::max(grain, Index {1});
+  auto const split = [&group, &body, chunk](auto const& self, Index from, Index to) -> void {
+    while (to - from > chunk) {
+      auto const middle = from + (to - from) / 2;
+      group.spawn([&self, middle, to] { self(self, middle, to); });
+      to = middle;
+    }
+    for (auto index = from; index < to; ++index) {
+      body(index);
+    }
+  };
+
+  split(split, begin, end);
+  group.join();
+}
+} // namespace age
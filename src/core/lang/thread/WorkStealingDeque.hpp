@@ -0,0 +1,120 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#pragma once
+#include <CDS/memory/UniquePointer>
+#include <CDS/meta/TypeTraits>
+#include <atomic>
+#include <type_traits>
+#include <vector>
+
+namespace age::meta {
+/// \brief Chase-Lev work-stealing deque of pointers, following Le et al., "Correct and Efficient Work-Stealing for
+/// Weak Memory Models". The owning thread pushes and pops at the bottom, any other thread steals from the top. The
+/// buffer grows when full; replaced buffers are kept until the deque is destroyed, since a thief may still read them.
+template <typename T> class WorkStealingDeque {
+  static_assert(std::is_pointer_v<T>, "WorkStealingDeque holds pointers, nullptr meaning empty");
+
+public:
+  explicit WorkStealingDeque(cds::Size capacity = 256u) noexcept(false) {
+    auto size = cds::Size {1u};
+    while (size < capacity) {
+      size <<= 1u;
+    }
+    _array.store(_buffers.emplace_back(cds::makeUnique<Buffer>(size)).get(), std::memory_order_relaxed);
+  }
+
+  WorkStealingDeque(WorkStealingDeque const&) = delete;
+  WorkStealingDeque(WorkStealingDeque&&) = delete;
+  ~WorkStealingDeque() noexcept = default;
+
+  auto operator=(WorkStealingDeque const&) = delete;
+  auto operator=(WorkStealingDeque&&) = delete;
+
+  /// \brief Owner only.
+  auto push(T item) noexcept(false) -> void {
+    auto const bottom = _bottom.load(std::memory_order_relaxed);
+    auto const top = _top.load(std::memory_order_acquire);
+    auto* pArray = _array.load(std::memory_order_relaxed);
+    if (bottom - top > static_cast<cds::sint64>(pArray->mask)) {
+      pArray = grow(pArray, top, bottom);
+    }
+
+    // A release store rather than the paper's release fence: same ordering, but visible to race detectors
+    pArray->at(bottom).store(item, std::memory_order_relaxed);
+    _bottom.store(bottom + 1, std::memory_order_release);
+  }
+
+  /// \brief Owner only. Takes the most recently pushed item, or returns nullptr if the deque is empty.
+  auto pop() noexcept -> T {
+    auto const bottom = _bottom.load(std::memory_order_relaxed) - 1;
+    auto* pArray = _array.load(std::memory_order_relaxed);
+    _bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto top = _top.load(std::memory_order_relaxed);
+
+    if (top > bottom) {
+      _bottom.store(bottom + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+
+    auto item = pArray->at(bottom).load(std::memory_order_relaxed);
+    if (top == bottom) {
+      // Last item: race the thieves for it
+      if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        item = nullptr;
+      }
+      _bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return item;
+  }
+
+  /// \brief Takes the least recently pushed item. Returns nullptr if the deque is empty or another thread won the
+  /// item.
+  auto steal() noexcept -> T {
+    auto top = _top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto const bottom = _bottom.load(std::memory_order_acquire);
+    if (top >= bottom) {
+      return nullptr;
+    }
+
+    auto item = _array.load(std::memory_order_acquire)->at(top).load(std::memory_order_relaxed);
+    if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return item;
+  }
+
+  /// \brief Approximate when called concurrently with push, pop or steal.
+  [[nodiscard]] auto empty() const noexcept {
+    return _bottom.load(std::memory_order_relaxed) <= _top.load(std::memory_order_relaxed);
+  }
+
+private:
+  struct Buffer {
+    explicit Buffer(cds::Size size) noexcept(false) : mask(size - 1u), items(size) {}
+
+    [[nodiscard]] auto& at(cds::sint64 index) noexcept { return items[static_cast<cds::Size>(index) & mask]; }
+
+    cds::Size mask;
+    std::vector<std::atomic<T>> items;
+  };
+
+  auto grow(Buffer* pArray, cds::sint64 top, cds::sint64 bottom) noexcept(false) -> Buffer* {
+    auto* pGrown = _buffers.emplace_back(cds::makeUnique<Buffer>((pArray->mask + 1u) * 2u)).get();
+    for (auto index = top; index < bottom; ++index) {
+      pGrown->at(index).store(pArray->at(index).load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    _array.store(pGrown, std::memory_order_release);
+    return pGrown;
+  }
+
+  alignas(64) std::atomic<cds::sint64> _top {0};
+  alignas(64) std::atomic<cds::sint64> _bottom {0};
+  std::atomic<Buffer*> _array {nullptr};
+  /// \brief Owner only.
+  std::vector<cds::UniquePointer<Buffer>> _buffers;
+};
+} // namespace age::meta
@@ -0,0 +1,311 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include "BinaryLogFormat.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <deque>
+#include <istream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <CDS/threading/Lock>
+#include <CDS/threading/Mutex>
+
+namespace {
+using namespace age;
+using namespace age::meta;
+using namespace cds;
+using namespace std;
+
+constexpr char const binaryLogMagic[] = {'A', 'G', 'E', 'L', 'O', 'G', '\x01', '\x00'};
+
+struct SiteKey {
+  char const* file;
+  char const* function;
+  uint32 line;
+  uint32 column;
+
+  auto operator==(SiteKey const&) const noexcept -> bool = default;
+};
+
+struct SiteKeyHash {
+  auto operator()(SiteKey const& key) const noexcept -> size_t {
+    auto hash = std::hash<void const*>()(key.file);
+    hash = hash * 31u + std::hash<void const*>()(key.function);
+    hash = hash * 31u + key.line;
+    return hash * 31u + key.column;
+  }
+};
+
+struct Site {
+  StringRef file;
+  StringRef function;
+  uint32 line;
+  uint32 column;
+};
+
+class SiteRegistry {
+public:
+  auto intern(SiteKey const& key, LogRecordFields const& fields) noexcept(false) -> uint32 {
+    Lock lock(_lock);
+    auto const [position, inserted] = _ids.try_emplace(key, static_cast<uint32>(_sites.size()));
+    if (inserted) {
+      _sites.push_back({fields.file, fields.function, fields.line, fields.column});
+    }
+    return position->second;
+  }
+
+  auto site(uint32 id) noexcept(false) -> Site {
+    Lock lock(_lock);
+    if (id >= _sites.size()) {
+      throw out_of_range("Unknown binary log site " + to_string(id));
+    }
+    return _sites[id];
+  }
+
+private:
+  Mutex _lock;
+  unordered_map<SiteKey, uint32, SiteKeyHash> _ids;
+  deque<Site> _sites;
+};
+
+auto& registry() noexcept {
+  static SiteRegistry siteRegistry;
+  return siteRegistry;
+}
+
+/// \brief Per-stream count of defined sites, plus one once the magic was written.
+auto definedSitesSlot() noexcept {
+  static int const slot = ios_base::xalloc();
+  return slot;
+}
+
+/// \brief Per-thread direct-mapped cache in front of the registry, so hot call sites do not take its lock.
+struct CachedSite {
+  SiteKey key {nullptr, nullptr, 0u, 0u};
+  uint32 id {0u};
+};
+
+template <typename T> auto append(string& into, T value) {
+  auto bits = static_cast<make_unsigned_t<T>>(value);
+  char bytes[sizeof(T)];
+  for (auto& byte : bytes) {
+    byte = static_cast<char>(bits & 0xFFu);
+    bits = static_cast<make_unsigned_t<T>>(bits >> 8u);
+  }
+  into.append(bytes, sizeof(T));
+}
+
+auto append(string& into, StringRef data) { into.append(data.data(), data.size()); }
+
+auto encodeSite(string& into, uint32 id, Site const& site) {
+  append(into, static_cast<uint8>(BinaryLogEntry::Site));
+  append(into, id);
+  append(into, site.line);
+  append(into, site.column);
+  append(into, static_cast<uint32>(site.file.size()));
+  append(into, static_cast<uint32>(site.function.size()));
+  append(into, site.file);
+  append(into, site.function);
+}
+
+class Reader {
+public:
+  explicit Reader(istream& in) noexcept : _in(in) {}
+
+  template <typename T> auto read(T& value) -> bool {
+    unsigned char bytes[sizeof(T)];
+    if (!_in.read(reinterpret_cast<char*>(bytes), sizeof(T))) {
+      return false;
+    }
+
+    make_unsigned_t<T> bits = 0u;
+    for (auto index = sizeof(T); index > 0u; --index) {
+      bits = static_cast<make_unsigned_t<T>>((bits << 8u) | bytes[index - 1u]);
+    }
+    value = static_cast<T>(bits);
+    return true;
+  }
+
+  /// \brief Reads in bounded chunks, since the length is untrusted: a corrupt length fails at the end of the input
+  /// instead of allocating the whole of it upfront.
+  auto read(string& value, uint32 length) -> bool {
+    value.clear();
+    while (value.size() < length) {
+      auto const offset = value.size();
+      auto const count = std::min<size_t>(length - offset, chunkSize);
+      value.resize(offset + count);
+      if (!_in.read(value.data() + offset, static_cast<streamsize>(count))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+private:
+  static constexpr size_t const chunkSize = 64u * 1024u;
+
+  istream& _in;
+};
+
+struct DecodedSite {
+  string file;
+  string function;
+  uint32 line {0u};
+  uint32 column {0u};
+};
+
+auto decodeSite(Reader& reader, vector<DecodedSite>& sites) -> bool {
+  uint32 id = 0u;
+  uint32 fileLength = 0u;
+  uint32 functionLength = 0u;
+  DecodedSite site;
+  if (!reader.read(id) || !reader.read(site.line) || !reader.read(site.column) || !reader.read(fileLength)
+      || !reader.read(functionLength) || !reader.read(site.file, fileLength)
+      || !reader.read(site.function, functionLength)) {
+    return false;
+  }
+
+  // Writers define sites in increasing id order, so an id may only redefine a known site or define the next one
+  if (id > sites.size()) {
+    return false;
+  }
+
+  if (id == sites.size()) {
+    sites.push_back(std::move(site));
+  } else {
+    sites[id] = std::move(site);
+  }
+  return true;
+}
+
+auto decodeRecord(Reader& reader, vector<DecodedSite> const& sites, ostream& out) -> bool {
+  uint32 site = 0u;
+  uint32 options = 0u;
+  uint32 level = 0u;
+  uint32 nameLength = 0u;
+  uint32 bodyLength = 0u;
+  string name;
+  string body;
+  LogRecordFields fields;
+  if (!reader.read(site) || !reader.read(options) || !reader.read(level) || !reader.read(fields.timestamp)
+      || !reader.read(fields.threadId) || !reader.read(nameLength) || !reader.read(bodyLength)
+      || !reader.read(name, nameLength) || !reader.read(body, bodyLength)) {
+    return false;
+  }
+
+  if (site >= sites.size() || !std::has_single_bit(level) || (level & logLevelMask) != level) {
+    return false;
+  }
+
+  fields.file = sites[site].file;
+  fields.function = sites[site].function;
+  fields.line = sites[site].line;
+  fields.column = sites[site].column;
+  fields.name = name;
+  fields.level = static_cast<LogLevelFlagBits>(level);
+
+  stringstream line;
+  formatLogHeader(line, options, fields);
+  line << body;
+  if (auto const text = line.str(); !text.empty()) {
+    out << text << '\n';
+  }
+  return true;
+}
+} // namespace
+
+namespace age::meta {
+auto internLogSite(LogRecordFields const& fields) noexcept(false) -> uint32 {
+  thread_local array<CachedSite, 64u> cache;
+
+  SiteKey const key {fields.file.data(), fields.function.data(), fields.line, fields.column};
+  auto& cached = cache[SiteKeyHash()(key) % cache.size()];
+  if (cached.key != key) {
+    cached = {key, registry().intern(key, fields)};
+  }
+  return cached.id;
+}
+
+auto encodeLogRecord(string& into, uint32 site, LogOptionFlags options, LogRecordFields const& fields,
+                     StringRef body) noexcept(false) -> void {
+  append(into, static_cast<uint8>(BinaryLogEntry::Record));
+  append(into, site);
+  append(into, options);
+  append(into, static_cast<uint32>(fields.level));
+  append(into, fields.timestamp);
+  append(into, fields.threadId);
+  append(into, static_cast<uint32>(fields.name.size()));
+  append(into, static_cast<uint32>(body.size()));
+  append(into, fields.name);
+  append(into, body);
+}
+
+auto writeBinaryLogRecord(ostream& out, uint32 site, StringRef encoded) noexcept(false) -> void {
+  // Checked before anything is written, so an unknown site cannot leave a partial entry behind
+  (void) registry().site(site);
+  auto& defined = out.iword(definedSitesSlot());
+  if (defined == 0) {
+    out.write(binaryLogMagic, sizeof(binaryLogMagic));
+    defined = 1;
+  }
+
+  if (static_cast<long>(site) >= defined - 1) {
+    string definitions;
+    for (; static_cast<long>(site) >= defined - 1; ++defined) {
+      auto const id = static_cast<uint32>(defined - 1);
+      encodeSite(definitions, id, registry().site(id));
+    }
+    out.write(definitions.data(), static_cast<streamsize>(definitions.size()));
+  }
+
+  out.write(encoded.data(), static_cast<streamsize>(encoded.size()));
+}
+
+auto restartBinaryLog(ostream& out) noexcept -> void { out.iword(definedSitesSlot()) = 0; }
+
+auto decodeBinaryLog(istream& in, ostream& out) noexcept(false) -> bool {
+  char magic[sizeof(binaryLogMagic)];
+  if (!in.read(magic, sizeof(magic)) || !std::equal(std::begin(magic), std::end(magic), binaryLogMagic)) {
+    return false;
+  }
+
+  Reader reader(in);
+  vector<DecodedSite> sites;
+  while (true) {
+    uint8 kind = 0u;
+    if (!reader.read(kind)) {
+      return in.eof();
+    }
+
+    if (kind == 0u) {
+      continue;
+    }
+
+    if (kind == static_cast<uint8>(binaryLogMagic[0])) {
+      magic[0] = binaryLogMagic[0];
+      if (!in.read(magic + 1, sizeof(magic) - 1u) || !std::equal(std::begin(magic), std::end(magic), binaryLogMagic)) {
+        return false;
+      }
+      sites.clear();
+      continue;
+    }
+
+    auto const decoded = kind == static_cast<uint8>(BinaryLogEntry::Site)   ? decodeSite(reader, sites)
+                         : kind == static_cast<uint8>(BinaryLogEntry::Record) ? decodeRecord(reader, sites, out)
+                                                                            : false;
+    if (!decoded) {
+      return false;
+    }
+  }
+}
+} // namespace age::meta
@@ -0,0 +1,42 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#pragma once
+
+#include <iosfwd>
+#include <string>
+
+#include <logging/Logger.hpp>
+
+namespace age::meta {
+/// \brief Layout of a binary log stream. All integers are little-endian.
+///
+///   stream: magic "AGELOG" 0x01 0x00, then entries
+///   Site:   u8 kind, u32 id, u32 line, u32 column, u32 file length, u32 function length, file, function
+///   Record: u8 kind, u32 site, u32 options, u32 level, s64 timestamp, u64 thread id, u32 name length,
+///           u32 body length, name, body
+///
+/// A site is written to a stream before the first record referencing it, so every stream decodes on its own. Appending
+/// to an existing log starts over with the magic, after which site ids restart. Zero bytes between entries are padding
+/// left in a mapped file by a crash, and are skipped.
+enum class BinaryLogEntry : cds::uint8 { Site = 1u, Record = 2u };
+
+/// \brief Returns the id of the call site the record was created at, assigning one on first use.
+[[nodiscard]] auto internLogSite(LogRecordFields const& fields) noexcept(false) -> cds::uint32;
+
+/// \brief Appends the Record entry for the given fields and already streamed body.
+auto encodeLogRecord(std::string& into, cds::uint32 site, LogOptionFlags options, LogRecordFields const& fields,
+                     StringRef body) noexcept(false) -> void;
+
+/// \brief Writes an encoded record, preceded by the stream magic and any site not yet defined on this stream.
+/// Callers must hold the output's lock. Throws std::out_of_range, writing nothing, if the site was never interned.
+auto writeBinaryLogRecord(std::ostream& out, cds::uint32 site, StringRef encoded) noexcept(false) -> void;
+
+/// \brief Forgets the magic and sites written to the stream, so the next record starts a new log. Streams switching to
+/// a new file call it, e.g. on rotation. Callers must hold the output's lock.
+auto restartBinaryLog(std::ostream& out) noexcept -> void;
+
+/// \brief Renders a binary log stream back into the text layout. Returns false on malformed or truncated input.
+[[nodiscard]] auto decodeBinaryLog(std::istream& in, std::ostream& out) noexcept(false) -> bool;
+} // namespace age::meta
@@ -0,0 +1,353 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include "FlightRecorder.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <utility>
+
+#include <CDS/threading/Lock>
+
+#if defined(__linux) | defined(__APPLE__)
+#include <csignal>
+#include <unistd.h>
+#define AGE_FLIGHT_RECORDER_SIGNALS true
+#else
+#define AGE_FLIGHT_RECORDER_SIGNALS false
+#endif
+
+namespace {
+using namespace age;
+using namespace cds;
+using namespace std;
+
+constexpr auto const noCursor = static_cast<Size>(-1);
+
+auto nextRecorderId() noexcept -> uint64 {
+  static atomic<uint64> next {1u};
+  return next.fetch_add(1u, memory_order_relaxed);
+}
+
+/// \brief Ids of the live recorders. Exiting threads only hand back the rings of recorders still listed here.
+struct LiveRecorders {
+  Mutex lock;
+  vector<uint64> ids;
+};
+
+auto liveRecorders() noexcept -> LiveRecorders& {
+  static LiveRecorders live;
+  return live;
+}
+
+/// \brief Recorders dumped by the fatal signal handler. Fixed-size, so the handler only reads atomics.
+atomic<FlightRecorder*> signalRecorders[8] {};
+
+#if AGE_FLIGHT_RECORDER_SIGNALS
+constexpr int const fatalSignals[] = {SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT};
+
+/// \brief Actions installed before the recorder handler, in the order of fatalSignals, which it chains to.
+struct sigaction previousActions[std::size(fatalSignals)] {};
+
+auto writeAll(int descriptor, char const* pData, Size size) noexcept {
+  while (size != 0u) {
+    auto const written = ::write(descriptor, pData, size);
+    if (written <= 0) {
+      return;
+    }
+    pData += written;
+    size -= static_cast<Size>(written);
+  }
+}
+#endif
+} // namespace
+
+namespace age {
+auto dumpFlightRecorders(int signal) noexcept -> void {
+  for (auto& slot : signalRecorders) {
+    if (auto* pRecorder = slot.load(memory_order_acquire); pRecorder != nullptr) {
+      pRecorder->dumpTo(pRecorder->_signalDescriptor);
+    }
+  }
+
+#if AGE_FLIGHT_RECORDER_SIGNALS
+  // The signal is blocked while handled, so raising it again reaches the previous action once this handler returns
+  for (Size index = 0u; index < std::size(fatalSignals); ++index) {
+    if (fatalSignals[index] == signal) {
+      (void) sigaction(signal, &previousActions[index], nullptr);
+    }
+  }
+  (void) raise(signal);
+#else
+  (void) signal;
+#endif
+}
+
+FlightRecorder::Ring::Ring(FlightRecorderConfig const& config) noexcept(false) :
+    slots(config.recordsPerThread), text(config.recordsPerThread * config.recordSize) {}
+
+struct FlightRecorder::ThreadRings {
+  ThreadRings() noexcept = default;
+  ThreadRings(ThreadRings const&) = delete;
+  ThreadRings(ThreadRings&&) = delete;
+
+  ~ThreadRings() noexcept {
+    auto& live = liveRecorders();
+    Lock lock(live.lock);
+    for (auto const& [id, pRing] : owned) {
+      if (std::find(live.ids.begin(), live.ids.end(), id) != live.ids.end()) {
+        pRing->owned.store(false, memory_order_release);
+      }
+    }
+  }
+
+  auto operator=(ThreadRings const&) = delete;
+  auto operator=(ThreadRings&&) = delete;
+
+  vector<pair<uint64, Ring*>> owned;
+};
+
+FlightRecorder::FlightRecorder(std::ostream& dumpTo, FlightRecorderConfig config) noexcept(false) :
+    _config(config), _dumpTo(dumpTo), _id(nextRecorderId()), _rings(config.threads), _signalCursors(config.threads) {
+  _config.recordsPerThread = std::max(_config.recordsPerThread, Size {1u});
+
+  auto& live = liveRecorders();
+  Lock lock(live.lock);
+  live.ids.push_back(_id);
+}
+
+FlightRecorder::~FlightRecorder() noexcept {
+  for (auto& slot : signalRecorders) {
+    auto* pExpected = this;
+    (void) slot.compare_exchange_strong(pExpected, nullptr, memory_order_acq_rel);
+  }
+
+  {
+    // Threads exiting from now on keep their rings, which are about to be deleted
+    auto& live = liveRecorders();
+    Lock lock(live.lock);
+    std::erase(live.ids, _id);
+  }
+
+  for (auto& ring : _rings) {
+    delete ring.load(memory_order_relaxed);
+  }
+}
+
+auto FlightRecorder::ring() noexcept(false) -> Ring* {
+  thread_local ThreadRings rings;
+  for (auto const& [id, pRing] : rings.owned) {
+    if (id == _id) {
+      return pRing;
+    }
+  }
+
+  // Reserved first, so that a claimed ring is always handed back. A thread left without one retries on every record
+  rings.owned.reserve(rings.owned.size() + 1u);
+  auto* const pRing = claimRing();
+  if (pRing != nullptr) {
+    rings.owned.emplace_back(_id, pRing);
+  }
+  return pRing;
+}
+
+/// \brief Claims a ring handed back by an exited thread, or allocates a new one. Returns nullptr if all are owned.
+auto FlightRecorder::claimRing() noexcept(false) -> Ring* {
+  auto const allocated = std::min(_claimedRings.load(memory_order_acquire), _rings.size());
+  for (Size index = 0u; index < allocated; ++index) {
+    auto* const pRing = _rings[index].load(memory_order_acquire);
+    auto released = false;
+    if (pRing != nullptr && pRing->owned.compare_exchange_strong(released, true, memory_order_acquire)) {
+      return pRing;
+    }
+  }
+
+  if (allocated == _rings.size()) {
+    return nullptr;
+  }
+
+  if (auto const index = _claimedRings.fetch_add(1u, memory_order_relaxed); index < _rings.size()) {
+    auto* const pRing = new Ring(_config);
+    _rings[index].store(pRing, memory_order_release);
+    return pRing;
+  }
+  return nullptr;
+}
+
+auto FlightRecorder::record(meta::LogLevelFlagBits level, StringRef text) noexcept -> void {
+  Ring* pRing = nullptr;
+  try {
+    pRing = ring();
+  } catch (std::exception const&) {
+    // A ring that cannot be allocated leaves the thread without one, as when all are owned
+  }
+
+  if (pRing == nullptr) {
+    _dropped.fetch_add(1u, memory_order_relaxed);
+    return;
+  }
+
+  // Sequence lock: a slot reads 0 while its text is replaced, so a concurrent dump can detect the overwrite
+  auto& slot = pRing->slots[pRing->next];
+  auto const length = std::min(text.size(), _config.recordSize);
+  slot.sequence.store(0u, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  std::memcpy(pRing->text.data() + pRing->next * _config.recordSize, text.data(), length);
+  slot.length.store(length, memory_order_relaxed);
+  slot.sequence.store(_sequence.fetch_add(1u, memory_order_relaxed), memory_order_release);
+  pRing->next = (pRing->next + 1u) % _config.recordsPerThread;
+
+  // Records come from the footer of a LogWriter, which must not throw. A failed dump does not advance what was dumped,
+  // so its records are written by the next one
+  if (level == meta::LogLevelFlagBits::Error && _config.dumpOnError) {
+    try {
+      dump();
+    } catch (std::exception const&) {
+      _failedDumps.fetch_add(1u, memory_order_relaxed);
+    }
+  }
+}
+
+auto FlightRecorder::retained() const noexcept(false) -> vector<Retained> {
+  vector<Retained> records;
+  auto const from = _dumpedUntil.load(memory_order_acquire);
+  for (auto const& ring : _rings) {
+    auto const* pRing = ring.load(memory_order_acquire);
+    if (pRing == nullptr) {
+      continue;
+    }
+
+    for (Size index = 0u; index < pRing->slots.size(); ++index) {
+      if (auto const sequence = pRing->slots[index].sequence.load(memory_order_acquire); sequence >= from) {
+        records.push_back({sequence, pRing, index});
+      }
+    }
+  }
+
+  std::sort(records.begin(), records.end(),
+            [](Retained const& left, Retained const& right) { return left.sequence < right.sequence; });
+  return records;
+}
+
+auto FlightRecorder::dump() noexcept(false) -> void {
+  auto outData = _dumpTo.outData();
+  dump(outData.output());
+  outData.output().flush();
+}
+
+auto FlightRecorder::dump(std::ostream& out) noexcept(false) -> void {
+  Lock lock(_dumpLock);
+  vector<char> text(_config.recordSize);
+  auto last = Size {0u};
+  for (auto const& record : retained()) {
+    auto const& slot = record.pRing->slots[record.slot];
+    auto const length = slot.length.load(memory_order_relaxed);
+    std::memcpy(text.data(), record.pRing->text.data() + record.slot * _config.recordSize, length);
+    atomic_thread_fence(memory_order_acquire);
+    if (slot.sequence.load(memory_order_relaxed) != record.sequence) {
+      continue;
+    }
+
+    out.write(text.data(), static_cast<std::streamsize>(length));
+    out.put('\n');
+    last = record.sequence;
+  }
+
+  if (last != 0u) {
+    _dumpedUntil.store(last + 1u, memory_order_release);
+  }
+}
+
+auto FlightRecorder::dumpOnFatalSignal(int descriptor) noexcept -> bool {
+#if AGE_FLIGHT_RECORDER_SIGNALS
+  _signalDescriptor = descriptor;
+  auto registered = false;
+  for (auto& slot : signalRecorders) {
+    FlightRecorder* pExpected = nullptr;
+    if (slot.load(memory_order_relaxed) == this
+        || slot.compare_exchange_strong(pExpected, this, memory_order_acq_rel)) {
+      registered = true;
+      break;
+    }
+  }
+
+  static auto const installed = [] {
+    struct sigaction action {};
+    action.sa_handler = &dumpFlightRecorders;
+    sigemptyset(&action.sa_mask);
+    auto succeeded = true;
+    for (Size index = 0u; index < std::size(fatalSignals); ++index) {
+      succeeded = sigaction(fatalSignals[index], &action, &previousActions[index]) == 0 && succeeded;
+    }
+    return succeeded;
+  }();
+  return registered && installed;
+#else
+  (void) descriptor;
+  return false;
+#endif
+}
+
+/// \brief Signal-safe dump: merges the rings through preallocated cursors, without allocating, locking or copying.
+auto FlightRecorder::dumpTo(int descriptor) noexcept -> void {
+#if AGE_FLIGHT_RECORDER_SIGNALS
+  auto const from = _dumpedUntil.load(memory_order_acquire);
+  auto const sequenceAt = [](Ring const& ring, Size slot) {
+    return ring.slots[slot].sequence.load(memory_order_acquire);
+  };
+
+  // Every cursor starts on the oldest record of its ring not dumped yet
+  for (Size index = 0u; index < _rings.size(); ++index) {
+    _signalCursors[index] = noCursor;
+    if (auto const* pRing = _rings[index].load(memory_order_acquire); pRing != nullptr) {
+      auto oldest = static_cast<uint64>(-1);
+      for (Size slot = 0u; slot < pRing->slots.size(); ++slot) {
+        if (auto const sequence = sequenceAt(*pRing, slot); sequence >= from && sequence < oldest) {
+          oldest = sequence;
+          _signalCursors[index] = slot;
+        }
+      }
+    }
+  }
+
+  // Bounded, since rings still being written could otherwise keep the merge going
+  for (auto remaining = _rings.size() * _config.recordsPerThread; remaining != 0u; --remaining) {
+    auto best = noCursor;
+    auto bestSequence = static_cast<uint64>(-1);
+    for (Size index = 0u; index < _rings.size(); ++index) {
+      if (_signalCursors[index] == noCursor) {
+        continue;
+      }
+
+      // A slot being written, or overwritten since the cursor reached it, ends its ring
+      if (auto const sequence = sequenceAt(*_rings[index].load(memory_order_relaxed), _signalCursors[index]);
+          sequence < from) {
+        _signalCursors[index] = noCursor;
+      } else if (sequence < bestSequence) {
+        best = index;
+        bestSequence = sequence;
+      }
+    }
+
+    if (best == noCursor) {
+      return;
+    }
+
+    auto const& ring = *_rings[best].load(memory_order_relaxed);
+    auto& cursor = _signalCursors[best];
+    writeAll(descriptor, ring.text.data() + cursor * _config.recordSize,
+             ring.slots[cursor].length.load(memory_order_relaxed));
+    writeAll(descriptor, "\n", 1u);
+
+    auto const next = (cursor + 1u) % ring.slots.size();
+    auto const nextSequence = sequenceAt(ring, next);
+    cursor = nextSequence > bestSequence ? next : noCursor;
+  }
+#else
+  (void) descriptor;
+#endif
+}
+} // namespace age
@@ -0,0 +1,115 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#pragma once
+
+#include <atomic>
+#include <ostream>
+#include <vector>
+
+#include <CDS/meta/TypeTraits>
+#include <CDS/threading/Mutex>
+
+#include <logging/Logger.hpp>
+
+namespace age {
+struct FlightRecorderConfig {
+  /// \brief Records kept per thread. The oldest record of a thread is overwritten first.
+  cds::Size recordsPerThread {512u};
+  /// \brief Bytes kept per record, header included. Longer records are truncated.
+  cds::Size recordSize {256u};
+  /// \brief Number of per-thread rings. Rings of exited threads are reused, so only records of threads beyond it that
+  /// are alive at the same time are dropped and counted.
+  cds::Size threads {64u};
+  /// \brief Dump every retained record when an Error record is recorded.
+  bool dumpOnError {true};
+};
+
+/// \brief Logger output keeping the latest records of every thread in memory, with no I/O until the recorder is
+/// dumped: on demand, on an Error record, or on a fatal signal with dumpOnFatalSignal. Records are written into a ring
+/// owned by the writing thread, claimed on its first record, so recording takes no lock; only a shared counter orders
+/// records across threads. A thread hands its ring back on exit, to be claimed by a later thread, its records kept
+/// until overwritten. This makes verbose Debug logging affordable in production. It plugs in as any other
+/// output, filters included, e.g. Logger::get(name, std::cout, LoggerOutput(recorder, LoggerOutput::allowAll)).
+///
+/// A dump writes the records not dumped before, oldest first. A record overwritten while it is being dumped is
+/// skipped rather than printed torn.
+class FlightRecorder {
+public:
+  explicit FlightRecorder(std::ostream& dumpTo, FlightRecorderConfig config = {}) noexcept(false);
+  FlightRecorder(FlightRecorder const&) = delete;
+  FlightRecorder(FlightRecorder&&) = delete;
+  ~FlightRecorder() noexcept;
+
+  auto operator=(FlightRecorder const&) = delete;
+  auto operator=(FlightRecorder&&) = delete;
+
+  /// \brief Keeps a finished record, without its line terminator, in the ring of the calling thread. An Error record
+  /// dumps the recorder with dumpOnError; a dump that fails is counted by failedDumps instead of throwing.
+  auto record(meta::LogLevelFlagBits level, StringRef text) noexcept -> void;
+
+  /// \brief Writes the records not dumped yet to the stream given at construction.
+  auto dump() noexcept(false) -> void;
+
+  /// \brief Writes the records not dumped yet to the given stream.
+  auto dump(std::ostream& out) noexcept(false) -> void;
+
+  /// \brief Writes the retained records to the given file descriptor from the handler of SIGSEGV, SIGBUS, SIGFPE,
+  /// SIGILL and SIGABRT, then hands the signal to the action installed before, by default terminating the process. Only
+  /// available on POSIX systems.
+  auto dumpOnFatalSignal(int descriptor) noexcept -> bool;
+
+  [[nodiscard]] auto dropped() const noexcept { return _dropped.load(std::memory_order_relaxed); }
+  [[nodiscard]] auto failedDumps() const noexcept { return _failedDumps.load(std::memory_order_relaxed); }
+
+private:
+  struct Slot {
+    /// \brief Sequence of the record held, 0 while it is written.
+    std::atomic<cds::uint64> sequence {0u};
+    std::atomic<cds::Size> length {0u};
+  };
+
+  struct Ring {
+    explicit Ring(FlightRecorderConfig const& config) noexcept(false);
+
+    std::vector<Slot> slots;
+    std::vector<char> text;
+    /// \brief Only touched by the owning thread.
+    cds::Size next {0u};
+    /// \brief Cleared when the owning thread exits, handing the ring, next included, to the next thread claiming it.
+    std::atomic<bool> owned {true};
+  };
+
+  /// \brief Rings claimed by the calling thread, handed back when it exits.
+  struct ThreadRings;
+
+  /// \brief Position of a retained record, in dump order.
+  struct Retained {
+    cds::uint64 sequence;
+    Ring const* pRing;
+    cds::Size slot;
+  };
+
+  auto ring() noexcept(false) -> Ring*;
+  auto claimRing() noexcept(false) -> Ring*;
+  [[nodiscard]] auto retained() const noexcept(false) -> std::vector<Retained>;
+
+  friend auto dumpFlightRecorders(int signal) noexcept -> void;
+  auto dumpTo(int descriptor) noexcept -> void;
+
+  FlightRecorderConfig _config;
+  LoggerOutput _dumpTo;
+  cds::uint64 _id;
+  std::vector<std::atomic<Ring*>> _rings;
+  std::atomic<cds::Size> _claimedRings {0u};
+  std::atomic<cds::uint64> _sequence {1u};
+  std::atomic<cds::uint64> _dumpedUntil {1u};
+  std::atomic<cds::Size> _dropped {0u};
+  std::atomic<cds::Size> _failedDumps {0u};
+  cds::Mutex _dumpLock;
+  /// \brief Preallocated, since the signal handler must not allocate.
+  std::vector<cds::Size> _signalCursors;
+  int _signalDescriptor {-1};
+};
+} // namespace age
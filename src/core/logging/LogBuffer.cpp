@@ -0,0 +1,109 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include "LogBuffer.hpp"
+
+#include <array>
+
+namespace {
+using namespace age;
+using namespace age::meta;
+using namespace cds;
+
+class LogBufferPool {
+public:
+  static constexpr Size const depth = 4u;
+
+  auto acquire() noexcept -> LogBuffer* {
+    if (_used == depth) {
+      return nullptr;
+    }
+    return &_buffers[_used++];
+  }
+
+  auto release() noexcept -> void { --_used; }
+
+private:
+  std::array<LogBuffer, depth> _buffers;
+  Size _used {0u};
+};
+
+auto pool() noexcept -> LogBufferPool& {
+  thread_local LogBufferPool threadPool;
+  return threadPool;
+}
+} // namespace
+
+namespace age::meta {
+LogStreamBuffer::LogStreamBuffer() noexcept { reset(); }
+
+auto LogStreamBuffer::reset() noexcept -> void {
+  setp(_inline, _inline + inlineCapacity);
+  _spill.clear();
+}
+
+auto LogStreamBuffer::contents() noexcept(false) -> StringRef {
+  if (_spill.empty()) {
+    return {pbase(), static_cast<Size>(pptr() - pbase())};
+  }
+
+  spill();
+  return {_spill.data(), _spill.size()};
+}
+
+auto LogStreamBuffer::spill() noexcept(false) -> void {
+  _spill.append(pbase(), pptr());
+  setp(_inline, _inline + inlineCapacity);
+}
+
+auto LogStreamBuffer::overflow(int_type character) -> int_type {
+  spill();
+  if (!traits_type::eq_int_type(character, traits_type::eof())) {
+    _spill.push_back(traits_type::to_char_type(character));
+  }
+  return traits_type::not_eof(character);
+}
+
+auto LogStreamBuffer::xsputn(char const* data, std::streamsize count) -> std::streamsize {
+  if (count <= epptr() - pptr()) {
+    traits_type::copy(pptr(), data, static_cast<Size>(count));
+    pbump(static_cast<int>(count));
+    return count;
+  }
+
+  spill();
+  _spill.append(data, static_cast<Size>(count));
+  return count;
+}
+
+LogBuffer::LogBuffer() noexcept :
+    _stream(&_buffer), _defaultFlags(_stream.flags()), _defaultPrecision(_stream.precision()),
+    _defaultFill(_stream.fill()) {}
+
+auto LogBuffer::reset() noexcept -> void {
+  _buffer.reset();
+  _stream.clear();
+  _stream.flags(_defaultFlags);
+  _stream.precision(_defaultPrecision);
+  _stream.fill(_defaultFill);
+  _stream.width(0);
+}
+
+LogBufferLease::LogBufferLease(bool active) noexcept(false) :
+    _pBuffer(active ? pool().acquire() : nullptr), _pooled(_pBuffer != nullptr) {
+  if (active && !_pooled) {
+    _pBuffer = new LogBuffer();
+  }
+}
+
+LogBufferLease::~LogBufferLease() noexcept {
+  if (!_pooled) {
+    delete _pBuffer;
+    return;
+  }
+
+  _pBuffer->reset();
+  pool().release();
+}
+} // namespace age::meta
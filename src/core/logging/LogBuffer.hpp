@@ -0,0 +1,87 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#pragma once
+
+#include <ostream>
+#include <streambuf>
+#include <string>
+
+#include <CDS/meta/TypeTraits>
+
+#include <lang/string/StringRef.hpp>
+
+namespace age::meta {
+/// \brief Stream buffer formatting into fixed inline storage. Records exceeding it spill into a heap string which keeps
+/// its capacity between records, so a thread only allocates while its longest record so far is still growing.
+class LogStreamBuffer : public std::streambuf {
+public:
+  static constexpr cds::Size const inlineCapacity = 1024u;
+
+  LogStreamBuffer() noexcept;
+  LogStreamBuffer(LogStreamBuffer const&) = delete;
+  LogStreamBuffer(LogStreamBuffer&&) = delete;
+  ~LogStreamBuffer() noexcept override = default;
+
+  auto operator=(LogStreamBuffer const&) = delete;
+  auto operator=(LogStreamBuffer&&) = delete;
+
+  auto reset() noexcept -> void;
+  [[nodiscard]] auto contents() noexcept(false) -> StringRef;
+
+protected:
+  auto overflow(int_type character) -> int_type override;
+  auto xsputn(char const* data, std::streamsize count) -> std::streamsize override;
+
+private:
+  auto spill() noexcept(false) -> void;
+
+  char _inline[inlineCapacity] {};
+  std::string _spill;
+};
+
+/// \brief Formatting sink of a single LogWriter: a reusable ostream over a LogStreamBuffer.
+class LogBuffer {
+public:
+  LogBuffer() noexcept;
+  LogBuffer(LogBuffer const&) = delete;
+  LogBuffer(LogBuffer&&) = delete;
+  ~LogBuffer() noexcept = default;
+
+  auto operator=(LogBuffer const&) = delete;
+  auto operator=(LogBuffer&&) = delete;
+
+  [[nodiscard]] constexpr auto stream() noexcept -> std::ostream& { return _stream; }
+  [[nodiscard]] auto contents() noexcept(false) -> StringRef { return _buffer.contents(); }
+  auto reset() noexcept -> void;
+
+private:
+  LogStreamBuffer _buffer;
+  std::ostream _stream;
+  std::ios::fmtflags const _defaultFlags;
+  std::streamsize const _defaultPrecision;
+  char const _defaultFill;
+};
+
+/// \brief Borrows a LogBuffer from the calling thread's pool for the lifetime of a record. Nested records (logging
+/// while formatting another record) take the next pooled buffer, and fall back to a heap buffer past the pool depth.
+/// An inactive lease borrows nothing and must not be read from.
+class LogBufferLease {
+public:
+  explicit LogBufferLease(bool active = true) noexcept(false);
+  LogBufferLease(LogBufferLease const&) = delete;
+  LogBufferLease(LogBufferLease&&) = delete;
+  ~LogBufferLease() noexcept;
+
+  auto operator=(LogBufferLease const&) = delete;
+  auto operator=(LogBufferLease&&) = delete;
+
+  [[nodiscard]] constexpr auto stream() noexcept -> std::ostream& { return _pBuffer->stream(); }
+  [[nodiscard]] auto contents() noexcept(false) -> StringRef { return _pBuffer->contents(); }
+
+private:
+  LogBuffer* _pBuffer;
+  bool _pooled;
+};
+} // namespace age::meta
@@ -0,0 +1,258 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <new>
+#include <ostream>
+#include <source_location>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <CDS/meta/TypeTraits>
+
+#if defined(__cpp_lib_format) && __cpp_lib_format >= 202110l
+#include <format>
+#include <iterator>
+#define AGE_STD_FORMAT_AVAILABLE true
+#else
+#define AGE_STD_FORMAT_AVAILABLE false
+#endif
+
+namespace age::meta {
+static constexpr auto const invalidLogFormat = static_cast<cds::Size>(-1);
+
+/// \brief Number of {} placeholders in a log format string, or invalidLogFormat if a brace is neither part of a
+/// placeholder nor escaped as {{ or }}.
+[[nodiscard]] constexpr auto logFormatPlaceholders(std::string_view format) noexcept -> cds::Size {
+  cds::Size count = 0u;
+  for (cds::Size index = 0u; index < format.size(); ++index) {
+    if (format[index] == '{') {
+      if (index + 1u < format.size() && format[index + 1u] == '{') {
+        ++index;
+      } else if (index + 1u < format.size() && format[index + 1u] == '}') {
+        ++index;
+        ++count;
+      } else {
+        return invalidLogFormat;
+      }
+    } else if (format[index] == '}') {
+      if (index + 1u >= format.size() || format[index + 1u] != '}') {
+        return invalidLogFormat;
+      }
+      ++index;
+    }
+  }
+  return count;
+}
+
+// Not constexpr: reaching either one while checking a format string at compile time fails the build with its name.
+auto logFormatStringIsMalformed() -> void;
+auto logFormatArgumentCountMismatch() -> void;
+
+/// \brief Format string checked at compile time against the arguments passed with it. Also captures the call site,
+/// which a format string given as a template argument could not.
+template <typename... Args> class BasicLogFormat {
+public:
+  template <cds::Size length>
+  consteval explicit(false)
+      BasicLogFormat(char const (&format)[length],
+                     std::source_location const& location = std::source_location::current()) noexcept :
+      _format(format, length - 1u), _location(location) {
+    auto const placeholders = logFormatPlaceholders(_format);
+    if (placeholders == invalidLogFormat) {
+      logFormatStringIsMalformed();
+    }
+    if (placeholders != sizeof...(Args)) {
+      logFormatArgumentCountMismatch();
+    }
+  }
+
+  [[nodiscard]] constexpr auto get() const noexcept { return _format; }
+  [[nodiscard]] constexpr auto const& location() const noexcept { return _location; }
+
+private:
+  std::string_view _format;
+  std::source_location _location;
+};
+
+template <typename... Args> using LogFormat = BasicLogFormat<std::type_identity_t<Args>...>;
+
+/// \brief Writes one argument: with std::format when it knows the type, through operator<< otherwise.
+template <typename T> auto formatLogArgument(std::ostream& out, T const& value) -> void {
+#if AGE_STD_FORMAT_AVAILABLE
+  if constexpr (std::is_default_constructible_v<std::formatter<T, char>>) {
+    std::format_to(std::ostreambuf_iterator<char>(out), "{}", value);
+  } else {
+    out << value;
+  }
+#else
+  out << value;
+#endif
+}
+
+/// \brief Writes a format string checked by LogFormat, replacing each placeholder with the next argument.
+template <typename... Args>
+auto formatLogArguments(std::ostream& out, std::string_view format, Args const&... args) -> void {
+  auto const literal = [&out, &format]() {
+    cds::Size written = 0u;
+    while (written < format.size()) {
+      auto const character = format[written];
+      if (character == '{' && format[written + 1u] == '}') {
+        break;
+      }
+
+      out.put(character);
+      written += (character == '{' || character == '}') ? 2u : 1u;
+    }
+    format.remove_prefix(std::min(written + 2u, format.size()));
+  };
+
+  ((literal(), formatLogArgument(out, args)), ...);
+  literal();
+}
+
+/// \brief Non-owning character ranges, such as StringRef or cds::StringView, which are not convertible to
+/// std::string_view but expose their characters and length.
+template <typename T>
+concept LogCharacterRange = requires(T const& value) {
+  { value.data() } -> std::convertible_to<char const*>;
+  { value.size() } -> std::convertible_to<std::size_t>;
+} || requires(T const& value) {
+  { value.cStr() } -> std::convertible_to<char const*>;
+  { value.size() } -> std::convertible_to<std::size_t>;
+};
+
+template <typename T>
+concept LogStringArgument = !std::is_arithmetic_v<std::decay_t<T>>
+                         && (std::is_convertible_v<T const&, std::string_view> || LogCharacterRange<std::decay_t<T>>);
+
+/// \brief How an argument is kept until deferred formatting: by value, with anything string-like copied into a string
+/// so that the record does not refer to the caller's buffers.
+template <typename T>
+using StoredLogArgument = std::conditional_t<LogStringArgument<T>, std::string, std::decay_t<T>>;
+
+/// \brief Converts an argument to its stored form, copying the characters of string-like arguments.
+template <typename T> auto storeLogArgument(T&& value) -> StoredLogArgument<T> {
+  if constexpr (!LogStringArgument<T> || std::is_same_v<std::decay_t<T>, std::string>) {
+    return std::forward<T>(value);
+  } else if constexpr (std::is_convertible_v<T const&, char const*>) {
+    char const* pString = value;
+    return pString == nullptr ? std::string() : std::string(pString);
+  } else if constexpr (std::is_convertible_v<T const&, std::string_view>) {
+    return std::string(std::string_view(value));
+  } else if constexpr (requires { value.data(); }) {
+    return std::string(value.data(), value.size());
+  } else {
+    return std::string(value.cStr(), value.size());
+  }
+}
+
+/// \brief Format string and arguments of a record, captured by value and type-erased, so the text is only produced
+/// when a consumer, such as the asynchronous flusher, renders it. Small argument sets are stored inline.
+class LogArguments {
+public:
+  LogArguments() noexcept = default;
+
+  template <typename... Args>
+  explicit LogArguments(std::string_view format, Args&&... args) :
+      _format(format), _pOperations(&operationsFor<Stored<Args...>>) {
+    using Tuple = Stored<Args...>;
+    if constexpr (storedInline<Tuple>()) {
+      _pStorage = new (_inline) Tuple(storeLogArgument(std::forward<Args>(args))...);
+    } else {
+      _pStorage = new Tuple(storeLogArgument(std::forward<Args>(args))...);
+    }
+  }
+
+  LogArguments(LogArguments const&) = delete;
+  LogArguments(LogArguments&& arguments) noexcept { take(arguments); }
+
+  ~LogArguments() noexcept { reset(); }
+
+  auto operator=(LogArguments const&) = delete;
+  auto operator=(LogArguments&& arguments) noexcept -> LogArguments& {
+    if (this != &arguments) {
+      reset();
+      take(arguments);
+    }
+    return *this;
+  }
+
+  [[nodiscard]] explicit operator bool() const noexcept { return _pOperations != nullptr; }
+
+  auto render(std::ostream& out) const -> void {
+    if (_pOperations != nullptr) {
+      _pOperations->render(_pStorage, _format, out);
+    }
+  }
+
+  auto reset() noexcept -> void {
+    if (_pOperations != nullptr) {
+      _pOperations->destroy(_pStorage);
+      _pOperations = nullptr;
+      _pStorage = nullptr;
+    }
+  }
+
+private:
+  template <typename... Args> using Stored = std::tuple<StoredLogArgument<Args>...>;
+
+  struct Operations {
+    auto (*render)(void const* pStorage, std::string_view format, std::ostream& out) -> void;
+    auto (*relocate)(void* pFrom, void* pTo) noexcept -> void*;
+    auto (*destroy)(void* pStorage) noexcept -> void;
+  };
+
+  static constexpr cds::Size const inlineCapacity = 64u;
+
+  template <typename Tuple> static constexpr auto storedInline() noexcept {
+    return sizeof(Tuple) <= inlineCapacity && alignof(Tuple) <= alignof(std::max_align_t)
+        && std::is_nothrow_move_constructible_v<Tuple>;
+  }
+
+  template <typename Tuple>
+  static constexpr Operations const operationsFor {
+      [](void const* pStorage, std::string_view format, std::ostream& out) {
+        std::apply([&out, format](auto const&... values) { formatLogArguments(out, format, values...); },
+                   *static_cast<Tuple const*>(pStorage));
+      },
+      [](void* pFrom, void* pTo) noexcept -> void* {
+        if constexpr (storedInline<Tuple>()) {
+          auto* pMoved = new (pTo) Tuple(std::move(*static_cast<Tuple*>(pFrom)));
+          static_cast<Tuple*>(pFrom)->~Tuple();
+          return pMoved;
+        } else {
+          (void) pTo;
+          return pFrom;
+        }
+      },
+      [](void* pStorage) noexcept {
+        if constexpr (storedInline<Tuple>()) {
+          static_cast<Tuple*>(pStorage)->~Tuple();
+        } else {
+          delete static_cast<Tuple*>(pStorage);
+        }
+      }};
+
+  auto take(LogArguments& arguments) noexcept -> void {
+    _format = arguments._format;
+    _pOperations = std::exchange(arguments._pOperations, nullptr);
+    if (_pOperations != nullptr) {
+      _pStorage = _pOperations->relocate(std::exchange(arguments._pStorage, nullptr), _inline);
+    }
+  }
+
+  alignas(std::max_align_t) unsigned char _inline[inlineCapacity] {};
+  void* _pStorage {nullptr};
+  std::string_view _format;
+  Operations const* _pOperations {nullptr};
+};
+} // namespace age::meta
@@ -0,0 +1,188 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <CDS/meta/TypeTraits>
+
+namespace age {
+namespace meta {
+enum class LogOverflowPolicy : cds::uint32 { Block, DropNewest, DropOldest };
+} // namespace meta
+
+/// \brief Bounded, lock-free queue used to hand finished log records to the flusher thread.
+/// Slots are constructed once and filled / consumed in place, so neither side allocates. A slot only becomes reusable
+/// once the consume callback returns, so consumers should swap the data out rather than process it inside the slot.
+/// A fill callback may throw: its slot is then skipped by consumers, the record counts as dropped, and push rethrows.
+template <typename T> class LogQueue {
+public:
+  using OverflowPolicy = meta::LogOverflowPolicy;
+
+  explicit LogQueue(cds::Size capacity, OverflowPolicy policy = OverflowPolicy::Block) noexcept(false) :
+      _mask(std::bit_ceil(capacity < 2u ? 2u : capacity) - 1u), _cells(std::make_unique<Cell[]>(_mask + 1u)),
+      _policy(policy) {
+    for (cds::Size index = 0u; index <= _mask; ++index) {
+      _cells[index].sequence.store(index, std::memory_order_relaxed);
+    }
+  }
+
+  LogQueue(LogQueue const&) = delete;
+  LogQueue(LogQueue&&) = delete;
+  ~LogQueue() noexcept = default;
+
+  auto operator=(LogQueue const&) = delete;
+  auto operator=(LogQueue&&) = delete;
+
+  template <typename Fill> auto push(Fill&& fill) noexcept(false) -> bool {
+    return push(std::forward<Fill>(fill), [](T&) noexcept {});
+  }
+
+  /// \brief Pushes a record, handing any record evicted under OverflowPolicy::DropOldest to evict, so that it releases
+  /// what it holds instead of keeping it until its slot is reused.
+  template <typename Fill, typename Evict> auto push(Fill&& fill, Evict&& evict) noexcept(false) -> bool {
+    while (true) {
+      auto const observed = _released.load(std::memory_order_acquire);
+      if (tryPush(fill)) {
+        _accepted.fetch_add(1u, std::memory_order_release);
+        _pushes.fetch_add(1u, std::memory_order_release);
+        _pushes.notify_one();
+        return true;
+      }
+
+      switch (_policy) {
+        using enum meta::LogOverflowPolicy;
+        case Block: _released.wait(observed, std::memory_order_acquire); break;
+        case DropNewest: _dropped.fetch_add(1u, std::memory_order_relaxed); return false;
+        case DropOldest:
+          if (tryPop(evict)) {
+            _dropped.fetch_add(1u, std::memory_order_relaxed);
+            complete();
+          } else {
+            _released.wait(observed, std::memory_order_acquire);
+          }
+          break;
+      }
+    }
+  }
+
+  template <typename Consume> auto pop(Consume&& consume) noexcept -> bool {
+    return tryPop(std::forward<Consume>(consume));
+  }
+
+  /// \brief Returns a snapshot to be passed to awaitPush, taken before checking the queue for records.
+  [[nodiscard]] auto pushSnapshot() const noexcept { return _pushes.load(std::memory_order_acquire); }
+
+  /// \brief Blocks until a push (or an interrupt) happens after the given snapshot was taken.
+  auto awaitPush(cds::uint32 snapshot) const noexcept -> void { _pushes.wait(snapshot, std::memory_order_acquire); }
+
+  auto interrupt() noexcept -> void {
+    _pushes.fetch_add(1u, std::memory_order_release);
+    _pushes.notify_all();
+  }
+
+  /// \brief Marks one popped record as fully processed. Evicted records are completed by the queue itself.
+  auto complete() noexcept -> void {
+    _completed.fetch_add(1u, std::memory_order_release);
+    _completed.notify_all();
+  }
+
+  /// \brief Blocks until every record accepted before the call has been completed or evicted.
+  auto awaitDrained() const noexcept -> void {
+    auto const target = static_cast<cds::uint32>(_accepted.load(std::memory_order_acquire));
+    auto completed = _completed.load(std::memory_order_acquire);
+    while (static_cast<cds::sint32>(completed - target) < 0) {
+      _completed.wait(completed, std::memory_order_acquire);
+      completed = _completed.load(std::memory_order_acquire);
+    }
+  }
+
+  [[nodiscard]] auto dropped() const noexcept { return _dropped.load(std::memory_order_relaxed); }
+  [[nodiscard]] constexpr auto capacity() const noexcept { return _mask + 1u; }
+  [[nodiscard]] constexpr auto policy() const noexcept { return _policy; }
+
+private:
+  struct Cell {
+    std::atomic<cds::Size> sequence;
+    /// \brief Set when the fill callback threw. The position was claimed already, so the cell is still published.
+    bool skipped {false};
+    T data;
+  };
+
+  template <typename Fill> auto tryPush(Fill&& fill) noexcept(false) -> bool {
+    auto position = _tail.load(std::memory_order_relaxed);
+    while (true) {
+      auto& cell = _cells[position & _mask];
+      auto const sequence = cell.sequence.load(std::memory_order_acquire);
+      auto const difference = static_cast<std::make_signed_t<cds::Size>>(sequence - position);
+      if (difference == 0) {
+        if (_tail.compare_exchange_weak(position, position + 1u, std::memory_order_relaxed)) {
+          try {
+            fill(cell.data);
+          } catch (...) {
+            cell.skipped = true;
+            cell.sequence.store(position + 1u, std::memory_order_release);
+            _dropped.fetch_add(1u, std::memory_order_relaxed);
+            throw;
+          }
+
+          cell.skipped = false;
+          cell.sequence.store(position + 1u, std::memory_order_release);
+          return true;
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = _tail.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  template <typename Consume> auto tryPop(Consume&& consume) noexcept -> bool {
+    auto position = _head.load(std::memory_order_relaxed);
+    while (true) {
+      auto& cell = _cells[position & _mask];
+      auto const sequence = cell.sequence.load(std::memory_order_acquire);
+      auto const difference = static_cast<std::make_signed_t<cds::Size>>(sequence - (position + 1u));
+      if (difference == 0) {
+        if (_head.compare_exchange_weak(position, position + 1u, std::memory_order_relaxed)) {
+          auto const skipped = cell.skipped;
+          if (!skipped) {
+            consume(cell.data);
+          }
+
+          cell.sequence.store(position + _mask + 1u, std::memory_order_release);
+          _released.fetch_add(1u, std::memory_order_release);
+          _released.notify_all();
+          if (!skipped) {
+            return true;
+          }
+          position = _head.load(std::memory_order_relaxed);
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = _head.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  cds::Size const _mask;
+  std::unique_ptr<Cell[]> const _cells;
+  OverflowPolicy const _policy;
+
+  alignas(64) std::atomic<cds::Size> _tail {0u};
+  alignas(64) std::atomic<cds::Size> _head {0u};
+  alignas(64) std::atomic<cds::uint32> _pushes {0u};
+  std::atomic<cds::Size> _accepted {0u};
+  alignas(64) std::atomic<cds::uint32> _released {0u};
+  alignas(64) std::atomic<cds::uint32> _completed {0u};
+  std::atomic<cds::Size> _dropped {0u};
+};
+} // namespace age
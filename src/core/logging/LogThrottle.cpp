@@ -0,0 +1,109 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include "LogThrottle.hpp"
+
+#include <array>
+#include <functional>
+
+namespace {
+using namespace age::meta;
+using namespace cds;
+using namespace std;
+
+/// \brief Open-addressing table of call site throttles. The hash only picks the first slot probed: slots hold the file
+/// name, line and column of their site, which are compared in full. Slots are claimed once and never released.
+class SiteTable {
+public:
+  auto find(source_location const& where) noexcept -> LogThrottle* {
+    auto const start = hashOf(where);
+    for (Size probe = 0u; probe < siteThrottleCapacity; ++probe) {
+      auto& slot = _slots[(start + probe) & (siteThrottleCapacity - 1u)];
+      auto state = slot.state.load(memory_order_acquire);
+      if (state == Empty && slot.state.compare_exchange_strong(state, Claiming, memory_order_acquire)) {
+        slot.file = where.file_name();
+        slot.line = where.line();
+        slot.column = where.column();
+        slot.state.store(Ready, memory_order_release);
+        slot.state.notify_all();
+        return &slot.throttle;
+      }
+
+      // The site is published right after the claim, so waiting for it is short
+      while (state == Claiming) {
+        slot.state.wait(Claiming, memory_order_acquire);
+        state = slot.state.load(memory_order_acquire);
+      }
+
+      if (slot.file == where.file_name() && slot.line == where.line() && slot.column == where.column()) {
+        return &slot.throttle;
+      }
+    }
+    return nullptr;
+  }
+
+private:
+  enum State : uint32 { Empty, Claiming, Ready };
+
+  struct Slot {
+    atomic<uint32> state {Empty};
+    char const* file {nullptr};
+    uint32 line {0u};
+    uint32 column {0u};
+    LogThrottle throttle;
+  };
+
+  static auto hashOf(source_location const& where) noexcept -> Size {
+    auto key = static_cast<uint64>(hash<void const*>()(where.file_name()));
+    key ^= (static_cast<uint64>(where.line()) << 20u) ^ where.column();
+    return static_cast<Size>((key * 0x9E3779B97F4A7C15ull) >> 32u);
+  }
+
+  array<Slot, siteThrottleCapacity> _slots;
+};
+} // namespace
+
+namespace age::meta {
+auto LogThrottle::admit(LogThrottleConfig const& config, uint64 now) noexcept -> bool {
+  if (config.sampleEvery > 1u && _seen.fetch_add(1u, memory_order_relaxed) % config.sampleEvery != 0u) {
+    _suppressed.fetch_add(1u, memory_order_relaxed);
+    return false;
+  }
+
+  if (config.rateLimit == 0u) {
+    return true;
+  }
+
+  auto start = _windowStart.load(memory_order_relaxed);
+  if (now - start >= static_cast<uint64>(config.window.count())
+      && _windowStart.compare_exchange_strong(start, now, memory_order_relaxed)) {
+    _windowCount.store(0u, memory_order_relaxed);
+  }
+
+  if (_windowCount.fetch_add(1u, memory_order_relaxed) >= config.rateLimit) {
+    _suppressed.fetch_add(1u, memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
+auto LogThrottle::report(LogThrottleConfig const& config, uint64 now) noexcept -> uint64 {
+  auto last = _lastReport.load(memory_order_relaxed);
+  if (now - last < static_cast<uint64>(config.window.count())
+      || !_lastReport.compare_exchange_strong(last, now, memory_order_relaxed)) {
+    return 0u;
+  }
+  return _suppressed.exchange(0u, memory_order_relaxed);
+}
+
+auto throttleClock() noexcept -> uint64 {
+  using namespace chrono;
+  return static_cast<uint64>(duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+auto siteThrottle(source_location const& where) noexcept -> LogThrottle* {
+  static SiteTable table;
+  return table.find(where);
+}
+} // namespace age::meta
@@ -0,0 +1,58 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <source_location>
+
+#include <CDS/meta/TypeTraits>
+
+namespace age::meta {
+struct LogThrottleConfig {
+  /// \brief Records admitted per window. 0 disables rate limiting.
+  cds::uint32 rateLimit {0u};
+  /// \brief Length of a rate limiting window, also the minimum interval between suppression reports.
+  std::chrono::milliseconds window {1000};
+  /// \brief Admit one record out of every sampleEvery. 1 disables sampling.
+  cds::uint32 sampleEvery {1u};
+};
+
+/// \brief Rate limiting and sampling state of one scope (a call site or a logger). All operations are lock-free, so
+/// concurrent records of the same scope never serialize on it.
+class LogThrottle {
+public:
+  LogThrottle() noexcept = default;
+  LogThrottle(LogThrottle const&) = delete;
+  LogThrottle(LogThrottle&&) = delete;
+  ~LogThrottle() noexcept = default;
+
+  auto operator=(LogThrottle const&) = delete;
+  auto operator=(LogThrottle&&) = delete;
+
+  /// \brief Returns whether a record at the given time (in milliseconds) passes, counting it as suppressed if not.
+  [[nodiscard]] auto admit(LogThrottleConfig const& config, cds::uint64 now) noexcept -> bool;
+
+  /// \brief Returns the number of records suppressed since the previous report, at most once per window.
+  [[nodiscard]] auto report(LogThrottleConfig const& config, cds::uint64 now) noexcept -> cds::uint64;
+
+private:
+  std::atomic<cds::uint64> _windowStart {0u};
+  std::atomic<cds::uint32> _windowCount {0u};
+  std::atomic<cds::uint64> _seen {0u};
+  std::atomic<cds::uint64> _suppressed {0u};
+  std::atomic<cds::uint64> _lastReport {0u};
+};
+
+/// \brief Milliseconds on the steady clock, the time base of LogThrottle.
+[[nodiscard]] auto throttleClock() noexcept -> cds::uint64;
+
+/// \brief Number of call sites that get a throttle of their own.
+constexpr cds::Size const siteThrottleCapacity = 4096u;
+
+/// \brief Returns the throttle of a call site, or nullptr once siteThrottleCapacity other sites have one. Sites are told
+/// apart by the address of their file name, their line and their column.
+[[nodiscard]] auto siteThrottle(std::source_location const& where) noexcept -> LogThrottle*;
+} // namespace age::meta
@@ -3,21 +3,39 @@
 //
 
 #include "Logger.hpp"
+#include "BinaryLogFormat.hpp"
+#include "FlightRecorder.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <charconv>
 #include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <exception>
+#include <iterator>
+#include <utility>
+#include <vector>
 
 #include <CDS/HashMap>
 #include <CDS/threading/Lock>
 
-#define CI_FORMAT_AVAILABLE false
-
-#if defined(__cpp_lib_format) && __cpp_lib_format > 202207l && CI_FORMAT_AVAILABLE
-#include <format>
-#endif
-
-#include <CDS/TreeMap>
 #include <CDS/threading/Thread>
 
+namespace age::meta {
+/// \brief A registered stream and the mutex serializing the records written to it, shared by every LoggerOutput of
+/// that stream. Refs counts those outputs; an entry at zero may be recycled for another stream. Capabilities of the
+/// stream are detected once, when it is registered. The flush state is guarded by the mutex.
+struct LogStreamEntry {
+  std::atomic<std::ostream*> out {nullptr};
+  std::atomic<cds::uint32> refs {0u};
+  bool colourCapable {false};
+  bool unflushed {false};
+  std::chrono::steady_clock::time_point lastFlush {};
+  cds::Mutex mutex;
+};
+} // namespace age::meta
+
 namespace {
 using namespace age;
 using namespace age::meta;
@@ -25,91 +43,99 @@ using namespace cds;
 using namespace cds::meta;
 using namespace std;
 
-template <typename = LoggingEnabled> class LoggerContainer {};
-
-template <> class LoggerContainer<BoolConstant<false>> {
+/// \brief Per-thread timestamp text. The whole-second part is only reformatted when the second changes, the
+/// sub-second digits are patched in place on every record.
+class TimestampCache {
 public:
-  [[nodiscard]] [[maybe_unused]] auto& defaultOut() const noexcept {
-    (void) this;
-    return cout;
-  }
-
-  [[maybe_unused]] auto setDefaultOut(ostream const& out) const noexcept {
-    (void) this;
-    (void) out;
+  auto wallClock(sint64 timestamp, Size digits) noexcept -> StringRef {
+    using namespace chrono;
+    auto const time = sys_time<nanoseconds>(nanoseconds(timestamp));
+    auto const second = floor<seconds>(time);
+    if (second != _wallSecond) {
+      _wallSecond = second;
+      _wallLength = formatWallClock(second, _wall);
+    }
+    return withFraction(_wall, _wallLength, time - second, digits);
   }
 
-  [[maybe_unused]] auto get(Logger const& hint, Logger& whenDisabled) noexcept -> Logger& {
-    (void) hint;
-    return whenDisabled;
+  auto monotonic(sint64 timestamp, Size digits) noexcept -> StringRef {
+    using namespace chrono;
+    auto const elapsed = nanoseconds(timestamp);
+    auto const second = floor<seconds>(elapsed);
+    if (second != _monotonicSecond) {
+      _monotonicSecond = second;
+      _monotonicLength = static_cast<Size>(
+          std::to_chars(_monotonic, _monotonic + integralCapacity, second.count()).ptr - _monotonic);
+    }
+    return withFraction(_monotonic, _monotonicLength, elapsed - second, digits);
   }
 
-  [[maybe_unused]] auto reg(std::ostream& out) const noexcept { return makeTuple(&out, static_cast<Mutex*>(nullptr)); }
-};
-
-template <> class LoggerContainer<BoolConstant<true>> {
-public:
-  [[nodiscard]] auto& defaultOut() noexcept { return *_pDefaultOut; }
-  auto setDefaultOut(ostream& out) noexcept { _pDefaultOut = &out; }
+private:
+  static constexpr Size const integralCapacity = 32u;
+  static constexpr Size const capacity = integralCapacity + 10u;
 
-  auto get(Logger&& hint, Logger const& whenDisabled) noexcept -> Logger& {
-    (void) whenDisabled;
-    Lock lock(masterLock);
-    return _loggers.emplace(hint.name(), std::move(hint)).value();
+  static auto formatWallClock(chrono::sys_seconds second, char* buffer) noexcept -> Size {
+#if AGE_STD_FORMAT_AVAILABLE && defined(__cpp_lib_chrono) && __cpp_lib_chrono >= 201907l
+    using namespace chrono;
+    return static_cast<Size>(
+        std::format_to_n(buffer, integralCapacity, "{:%H:%M:%OS}", current_zone()->to_local(second)).size);
+#else
+    auto asTimeT = chrono::system_clock::to_time_t(second);
+    tm timeInfo {};
+    localtime_r(&asTimeT, &timeInfo);
+    return std::strftime(buffer, integralCapacity, "%H:%M:%OS", &timeInfo);
+#endif
   }
 
-  auto reg(std::ostream& out) noexcept {
-    auto emplace = [this](auto& newOut) -> auto& {
-      for (auto& entry : locks) {
-        if (entry.get<0>() == &newOut) {
-          return entry;
-        }
-      }
-      return locks.emplace(makeTuple(&newOut, makeUnique<Mutex>()));
-    };
+  static auto withFraction(char* buffer, Size length, chrono::nanoseconds fraction, Size digits) noexcept
+      -> StringRef {
+    if (digits == 0u) {
+      return {buffer, length};
+    }
 
-    Lock lock(masterLock);
-    auto& entry = emplace(out);
-    return makeTuple(entry.get<0>(), entry.get<1>().get());
-  }
+    auto value = fraction.count();
+    for (auto skipped = digits; skipped < 9u; ++skipped) {
+      value /= 10;
+    }
 
-private:
-  ostream* _pDefaultOut {&cout};
-  TreeMap<StringRef, Logger> _loggers;
+    buffer[length] = '.';
+    for (auto index = length + digits; index > length; --index) {
+      buffer[index] = static_cast<char>('0' + value % 10);
+      value /= 10;
+    }
+    return {buffer, length + 1u + digits};
+  }
 
-  // TODO: HashMap fails with ValueType with deleted CopyCtor.
-  Array<Tuple<ostream*, UniquePointer<Mutex>>> locks;
-  Mutex masterLock;
+  char _wall[capacity] {};
+  Size _wallLength {0u};
+  chrono::sys_seconds _wallSecond {chrono::sys_seconds::min()};
+  char _monotonic[capacity] {};
+  Size _monotonicLength {0u};
+  chrono::seconds _monotonicSecond {chrono::seconds::min()};
 };
 
-auto& container() noexcept {
-  using C = LoggerContainer<>;
-  static UniquePointer<C> container;
-  if (!container) {
-    container = makeUnique<C>();
-  }
-  return *container;
+auto timestampCache() noexcept -> TimestampCache& {
+  thread_local TimestampCache cache;
+  return cache;
 }
 
-auto timestamp() {
-#if defined(__cpp_lib_format) && __cpp_lib_format > 202207l && CI_FORMAT_AVAILABLE
-  using namespace chrono;
-  return std::format("{:%H:%M:%OS}", current_zone()->to_local(system_clock::now()));
-#else
-  int const timeBufferSize = 512U;
-  using sys_clock = std::chrono::system_clock;
+auto const monotonicEpoch = chrono::steady_clock::now();
 
-  auto timePoint = sys_clock::now();
-  auto asTimeT = sys_clock::to_time_t(timePoint);
-  tm timeInfo {};
-  localtime_r(&asTimeT, &timeInfo);
+constexpr auto hasOption(LogOptionFlags options, LogOptionFlagBits option) noexcept {
+  return (options & option) != 0u;
+}
 
-  string asString(timeBufferSize, '\0');
-  asString.resize(std::strftime(asString.data(), timeBufferSize, "%H:%M:%OS", &timeInfo));
-  asString.resize(asString.length());
+auto captureTimestamp(LogOptionFlags options) noexcept -> sint64 {
+  using namespace chrono;
+  if (hasOption(options, LogOptionFlagBits::MonotonicTimestamp)) {
+    return duration_cast<nanoseconds>(steady_clock::now() - monotonicEpoch).count();
+  }
+  return duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count();
+}
 
-  return asString;
-#endif
+auto binaryScratch() noexcept -> string& {
+  thread_local string scratch;
+  return scratch;
 }
 
 auto toString(LogLevelFlagBits level) {
@@ -134,165 +160,792 @@ auto colour(LogLevelFlagBits level) {
 
 auto colourCompatibleOutput(std::ostream const& out) {
 #if defined(__linux) | defined(__APPLE__)
-  return (&out == &cout) || (&out == &clog) && isatty(1);
+  return ((&out == &cout) && isatty(1)) || ((&out == &clog) && isatty(2));
 #else
   return false;
 #endif
 }
 
+auto writeText(ostream& out, StringRef text) {
+  out.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+template <typename Integer> auto writeInteger(ostream& out, Integer value, int base = 10) {
+  char digits[24];
+  auto const end = std::to_chars(digits, digits + sizeof(digits), value, base).ptr;
+  out.write(digits, end - digits);
+}
+
 template <typename = LoggingEnabled> struct LockConfig {};
 
 template <> struct LockConfig<BoolConstant<true>> {
-  static auto lock(cds::Mutex* lock) { lock->lock(); }
-  static auto unlock(cds::Mutex* lock) { lock->unlock(); }
+  static auto lock(LogStreamEntry* pEntry) { pEntry->mutex.lock(); }
+  static auto unlock(LogStreamEntry* pEntry) { pEntry->mutex.unlock(); }
 };
 
 template <> struct LockConfig<BoolConstant<false>> {
-  [[maybe_unused]] static auto lock(cds::Mutex const* lock) { (void) lock; }
-  [[maybe_unused]] static auto unlock(cds::Mutex const* lock) { (void) lock; }
+  [[maybe_unused]] static auto lock(LogStreamEntry const* pEntry) { (void) pEntry; }
+  [[maybe_unused]] static auto unlock(LogStreamEntry const* pEntry) { (void) pEntry; }
 };
-} // namespace
 
-namespace age {
-namespace meta {
-auto LoggerImpl<BoolConstant<true>>::_header(std::ostream& out, source_location const& where, Level level) const
-    -> void {
-  addLocation(out, where);
-  addTimestamp(out, timestamp());
-  addName(out);
-  addLevel(out, level);
-  addThreadId(out);
-  addHeaderSpacing(out);
+/// \brief A finished record: its text for Text outputs and, if a Binary output accepts it, its encoding.
+struct PendingRecord {
+  StringRef text;
+  StringRef encoded;
+  uint32 site {0u};
+  LogLevelFlagBits level {LogLevelFlagBits::Info};
+  bool colourEnabled {false};
+};
+
+auto colouredScratch() noexcept -> string& {
+  thread_local string scratch;
+  return scratch;
 }
 
-auto LoggerImpl<BoolConstant<true>>::_footer(std::string const& contents, Level level) -> void {
-  for (auto& output : outputs()) {
-    if (output.allows(level)) {
+/// \brief Synchronous records flush a stream when they are errors, when it is a terminal, or when it was last flushed
+/// at least flushInterval ago. A stream they leave unflushed is flushed by the next record written to it once
+/// flushInterval elapsed, from the thread writing it, which is the only one that knows the stream is alive. Asynchronous
+/// records are flushed once per batch written by the flusher thread.
+enum class FlushPolicy { WhenDue, Deferred };
+
+constexpr auto const flushInterval = chrono::milliseconds(100);
+
+/// \brief Writes one finished record to several outputs. Each variant of the record, its plain text or the text
+/// wrapped in the colour codes of its level, is laid out at most once and reaches every output with a single write.
+class RecordFanOut {
+public:
+  explicit RecordFanOut(PendingRecord const& record) noexcept : _record(record) {}
+
+  /// \brief Returns whether this write left a previously flushed stream with unflushed data.
+  auto write(LoggerOutput const& output, FlushPolicy policy) -> bool {
+    if (output.format() == LogOutputFormat::Recorder) {
+      output.recorder()->record(_record.level, _record.text);
+      return false;
+    }
+
+    auto outData = output.outData();
+    auto& out = outData.output();
+    if (output.format() == LogOutputFormat::Binary) {
+      // Records formatted on the flusher thread were never encoded, so they have no site to reference
+      if (_record.encoded.empty()) {
+        return false;
+      }
+      writeBinaryLogRecord(out, _record.site, _record.encoded);
+    } else if (_record.colourEnabled && output.colourCapable()) {
+      auto const text = coloured();
+      out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    } else {
+      out.write(_record.text.data(), static_cast<std::streamsize>(_record.text.size()));
+      if (!_record.text.empty()) {
+        out.put('\n');
+      }
+    }
+
+    auto* const pEntry = outData.entry();
+    if (policy == FlushPolicy::WhenDue && flushDue(output, *pEntry)) {
+      out.flush();
+      pEntry->lastFlush = now();
+      pEntry->unflushed = false;
+      return false;
+    }
+    return !std::exchange(pEntry->unflushed, true);
+  }
+
+  /// \brief Flushes the outputs reported by write, if nothing flushed them since.
+  static auto flush(vector<LoggerOutput>& outputs) -> void {
+    for (auto const& output : outputs) {
       auto outData = output.outData();
-      auto& out = outData.output();
-      addColourHeader(out, level);
-      out << contents;
-      if (!contents.empty()) {
-        out << std::endl;
+      if (auto* const pEntry = outData.entry(); std::exchange(pEntry->unflushed, false)) {
+        outData.output().flush();
+        pEntry->lastFlush = chrono::steady_clock::now();
       }
-      addEndColourMarker(out);
     }
+    outputs.clear();
   }
-}
 
-auto LoggerImpl<BoolConstant<true>>::addColourHeader(ostream& out, Level level) const -> void {
-  if (!colourCompatibleOutput(out)) {
-    return;
+private:
+  auto coloured() -> StringRef {
+    auto& scratch = colouredScratch();
+    if (!_coloured) {
+      scratch.assign(colour(_record.level));
+      scratch.append(_record.text.data(), _record.text.size());
+      if (!_record.text.empty()) {
+        scratch.push_back('\n');
+      }
+      scratch.append("\033[1;0m");
+      _coloured = true;
+    }
+    return scratch;
   }
-  if (!optionEnabled(LogOptionFlagBits::OutputTerminalColour)) {
-    return;
+
+  auto flushDue(LoggerOutput const& output, LogStreamEntry const& entry) noexcept -> bool {
+    return _record.level == LogLevelFlagBits::Error || output.colourCapable()
+        || now() - entry.lastFlush >= flushInterval;
   }
-  out << colour(level);
-}
 
-auto LoggerImpl<BoolConstant<true>>::addEndColourMarker(ostream& out) const -> void {
-  if (!colourCompatibleOutput(out)) {
-    return;
+  auto now() noexcept -> chrono::steady_clock::time_point {
+    if (_now == chrono::steady_clock::time_point {}) {
+      _now = chrono::steady_clock::now();
+    }
+    return _now;
   }
-  if (!optionEnabled(LogOptionFlagBits::OutputTerminalColour)) {
-    return;
+
+  PendingRecord const& _record;
+  bool _coloured {false};
+  chrono::steady_clock::time_point _now {};
+};
+
+/// \brief A queued record. Deferred records carry their header fields and arguments instead of contents; name keeps
+/// a copy of the logger name, which may not outlive the record.
+struct AsyncRecord {
+  LogLevelFlagBits level {LogLevelFlagBits::Info};
+  bool colourEnabled {false};
+  uint32 site {0u};
+  string contents;
+  string encoded;
+  vector<LoggerOutput> targets;
+  LogArguments arguments;
+  LogRecordFields fields;
+  LogHeaderPlan header;
+  string name;
+};
+
+class AsyncFlusher {
+public:
+  AsyncFlusher(Size capacity, LogOverflowPolicy policy) noexcept(false) :
+      _queue(capacity, policy), _flusher(new Runnable([this] { run(); })) {
+    _flusher->start();
   }
-  out << "\033[1;0m";
-}
 
-auto LoggerImpl<BoolConstant<true>>::addLocation(ostream& out, source_location const& where) const -> void {
-  if (!optionEnabled(LogOptionFlagBits::SourceLocation) || (_options & requireSourceLocation) == 0u) {
-    return;
+  AsyncFlusher(AsyncFlusher const&) = delete;
+  AsyncFlusher(AsyncFlusher&&) = delete;
+  auto operator=(AsyncFlusher const&) = delete;
+  auto operator=(AsyncFlusher&&) = delete;
+
+  ~AsyncFlusher() noexcept {
+    _running.store(false, std::memory_order_release);
+    _queue.interrupt();
+    _flusher->join();
+  }
+
+  auto push(Array<LoggerOutput> const& outputs, PendingRecord const& pending) -> void {
+    auto const accepted = [&pending](auto const& output) { return output.allows(pending.level); };
+    if (std::none_of(outputs.begin(), outputs.end(), accepted)) {
+      return;
+    }
+
+    enqueue([&](AsyncRecord& record) {
+      record.level = pending.level;
+      record.colourEnabled = pending.colourEnabled;
+      record.site = pending.site;
+      record.contents.assign(pending.text.data(), pending.text.size());
+      record.encoded.assign(pending.encoded.data(), pending.encoded.size());
+      record.arguments.reset();
+      assignTargets(record, outputs);
+    });
   }
 
-  struct {
-    auto request() noexcept { toggle = true; }
-    auto consume() noexcept {
-      if (!toggle) {
+  auto push(Array<LoggerOutput> const& outputs, LogHeaderPlan const& header, LogRecordFields const& fields,
+            bool colourEnabled, LogArguments&& arguments) -> void {
+    auto const accepted = [&fields](auto const& output) { return output.allows(fields.level); };
+    if (std::none_of(outputs.begin(), outputs.end(), accepted)) {
+      return;
+    }
+
+    enqueue([&](AsyncRecord& record) {
+      record.level = fields.level;
+      record.colourEnabled = colourEnabled;
+      record.site = 0u;
+      record.encoded.clear();
+      record.arguments = std::move(arguments);
+      record.fields = fields;
+      record.header = header;
+      record.name.assign(fields.name.data(), fields.name.size());
+      assignTargets(record, outputs);
+    });
+  }
+
+  auto flush() const noexcept { _queue.awaitDrained(); }
+  [[nodiscard]] auto dropped() const noexcept { return _queue.dropped(); }
+
+private:
+  /// \brief Queues a record filled in place. A record that cannot be filled, e.g. for lack of memory, is counted as
+  /// dropped by the queue instead of failing the logging call.
+  template <typename Fill> auto enqueue(Fill&& fill) noexcept -> void {
+    // Evicted records release their outputs and arguments right away, as written ones do
+    auto const evict = [](AsyncRecord& record) noexcept {
+      record.targets.clear();
+      record.arguments.reset();
+    };
+
+    try {
+      (void) _queue.push(std::forward<Fill>(fill), evict);
+    } catch (std::exception const&) {
+      // empty on purpose
+    }
+  }
+
+  static auto assignTargets(AsyncRecord& record, Array<LoggerOutput> const& outputs) -> void {
+    record.targets.clear();
+    for (auto const& output : outputs) {
+      if (output.allows(record.level)) {
+        record.targets.push_back(output);
+      }
+    }
+  }
+
+  static auto render(AsyncRecord& record) -> void {
+    LogBufferLease buffer;
+    record.fields.name = record.name;
+    record.header.render(buffer.stream(), record.fields);
+    record.arguments.render(buffer.stream());
+    record.arguments.reset();
+    auto const contents = buffer.contents();
+    record.contents.assign(contents.data(), contents.size());
+  }
+
+  /// \brief Flushes the streams written by the current batch, then reports its records as complete, so that
+  /// Logger::flush only returns once they reached their streams.
+  auto completeBatch(vector<LoggerOutput>& unflushed, Size& batched) -> void {
+    RecordFanOut::flush(unflushed);
+    for (; batched != 0u; --batched) {
+      _queue.complete();
+    }
+  }
+
+  auto run() -> void {
+    AsyncRecord current;
+    auto const take = [&current](AsyncRecord& record) { std::swap(current, record); };
+    vector<LoggerOutput> unflushed;
+    Size batched = 0u;
+
+    while (true) {
+      auto const snapshot = _queue.pushSnapshot();
+      while (_queue.pop(take)) {
+        if (current.arguments) {
+          render(current);
+        }
+
+        PendingRecord const record {current.contents, current.encoded, current.site, current.level,
+                                    current.colourEnabled};
+        RecordFanOut fanOut {record};
+        for (auto const& output : current.targets) {
+          if (fanOut.write(output, FlushPolicy::Deferred)) {
+            unflushed.push_back(output);
+          }
+        }
+        // Written records must not keep their streams referenced, which the queue would until the slot is reused
+        current.targets.clear();
+
+        if (++batched == batchSize) {
+          completeBatch(unflushed, batched);
+        }
+      }
+      completeBatch(unflushed, batched);
+
+      if (!_running.load(std::memory_order_acquire)) {
         return;
       }
-      toggle = false;
-      out << ":";
+      _queue.awaitPush(snapshot);
     }
-    bool toggle;
-    ostream& out;
-  } sep {false, out};
+  }
 
-  auto writeLocationPart = [this, &sep, &out](auto flag, auto data) {
-    if (!optionEnabled(flag)) {
-      return;
+  static constexpr Size const batchSize = 64u;
+
+  LogQueue<AsyncRecord> _queue;
+  std::atomic<bool> _running {true};
+  UniquePointer<Thread> _flusher;
+};
+
+/// \brief Insert-only table of named loggers. Every bucket is a list published through an atomic head, so a lookup
+/// only follows acquire loads and never waits; an insertion publishes a fully constructed node with a single CAS and,
+/// on contention, only rescans the nodes pushed in the meantime. Nodes live until the table is destroyed, which keeps
+/// the references returned by Logger::get(name) stable.
+class LoggerTable {
+public:
+  LoggerTable() noexcept = default;
+  LoggerTable(LoggerTable const&) = delete;
+  LoggerTable(LoggerTable&&) = delete;
+  auto operator=(LoggerTable const&) = delete;
+  auto operator=(LoggerTable&&) = delete;
+
+  ~LoggerTable() noexcept {
+    for (auto& bucket : _buckets) {
+      for (auto* pNode = bucket.load(std::memory_order_relaxed); pNode != nullptr;) {
+        delete std::exchange(pNode, pNode->pNext);
+      }
+    }
+  }
+
+  template <typename Factory> auto get(StringRef name, Factory&& create) noexcept -> Logger& {
+    auto const hash = nameHash(name);
+    auto& head = _buckets[hash & (bucketCount - 1u)];
+    auto* pFirst = head.load(std::memory_order_acquire);
+    if (auto* pFound = find(pFirst, nullptr, hash, name); pFound != nullptr) {
+      return pFound->logger;
     }
-    sep.consume();
-    out << data;
-    sep.request();
+
+    auto pNode = makeUnique<Node>(hash, create(), pFirst);
+    while (!head.compare_exchange_weak(pNode->pNext, pNode.get(), std::memory_order_release,
+                                       std::memory_order_acquire)) {
+      if (auto* pFound = find(pNode->pNext, pFirst, hash, name); pFound != nullptr) {
+        return pFound->logger;
+      }
+      pFirst = pNode->pNext;
+    }
+    return pNode.release()->logger;
+  }
+
+private:
+  struct Node {
+    uint64 hash;
+    Logger logger;
+    Node* pNext;
   };
 
-  out << "[";
-  writeLocationPart(LogOptionFlagBits::SourceLocationFile, where.file_name());
-  writeLocationPart(LogOptionFlagBits::SourceLocationFunction, where.function_name());
-  writeLocationPart(LogOptionFlagBits::SourceLocationLine, where.line());
-  writeLocationPart(LogOptionFlagBits::SourceLocationColumn, where.column());
-  out << "]";
-}
+  static constexpr auto nameHash(StringRef name) noexcept {
+    uint64 hash = 0xCBF29CE484222325ull;
+    for (Size index = 0u; index < name.size(); ++index) {
+      hash = (hash ^ static_cast<unsigned char>(name.data()[index])) * 0x100000001B3ull;
+    }
+    return hash;
+  }
 
-auto LoggerImpl<BoolConstant<true>>::addTimestamp(ostream& out, StringRef timestamp) const -> void {
-  if (!optionEnabled(LogOptionFlagBits::Timestamp)) {
-    return;
+  /// \brief Searches the nodes from pFrom up to, not including, pUntil.
+  static auto find(Node* pFrom, Node const* pUntil, uint64 hash, StringRef name) noexcept -> Node* {
+    for (auto* pNode = pFrom; pNode != pUntil; pNode = pNode->pNext) {
+      if (pNode->hash == hash && std::is_eq(StringRef {pNode->logger.name()} <=> name)) {
+        return pNode;
+      }
+    }
+    return nullptr;
   }
-  out << "[";
-  if (optionEnabled(LogOptionFlagBits::InfoPrefix)) {
-    out << "time = ";
+
+  static constexpr Size const bucketCount = 256u;
+  std::atomic<Node*> _buckets[bucketCount] {};
+};
+
+/// \brief Open-addressing table of the streams used by logger outputs, keyed on the stream address.
+/// A registered stream is found by a lock-free probe followed by a CAS on the entry count, so constructing an output
+/// for a known stream neither locks nor scans. The registry lock is only taken to register a stream, which first
+/// recycles an unreferenced entry on the probe path. Short-lived streams therefore reuse entries instead of growing
+/// the table. Entries and replaced tables stay allocated until the registry is destroyed, since a concurrent reader
+/// may still hold them.
+class StreamRegistry {
+public:
+  StreamRegistry() noexcept(false) {
+    _pTable.store(_tables.emplace_back(makeUnique<Table>(initialCapacity)).get(), std::memory_order_release);
   }
-  out << timestamp << "]";
-}
 
-auto LoggerImpl<BoolConstant<true>>::addName(ostream& out) const -> void {
-  if (!optionEnabled(LogOptionFlagBits::LoggerName)) {
-    return;
+  auto acquire(ostream& out) noexcept(false) -> LogStreamEntry* {
+    if (auto* pEntry = find(*_pTable.load(std::memory_order_acquire), &out); pEntry != nullptr) {
+      return pEntry;
+    }
+
+    Lock lock(_lock);
+    auto* pTable = _pTable.load(std::memory_order_relaxed);
+    LogStreamEntry* pUnused = nullptr;
+    for (auto index = slotOf(*pTable, &out);; index = (index + 1u) & (pTable->size() - 1u)) {
+      auto* pEntry = (*pTable)[index].load(std::memory_order_relaxed);
+      if (pEntry == nullptr) {
+        break;
+      }
+
+      if (pEntry->out.load(std::memory_order_relaxed) == &out && retain(pEntry, &out)) {
+        return pEntry;
+      }
+
+      if (pUnused == nullptr && pEntry->refs.load(std::memory_order_acquire) == 0u) {
+        pUnused = pEntry;
+      }
+    }
+
+    if (pUnused != nullptr) {
+      return claim(pUnused, &out);
+    }
+
+    if ((_used + 1u) * 4u > pTable->size() * 3u) {
+      pTable = rebuild();
+    }
+    return insert(*pTable, claim(allocate(), &out));
+  }
+
+  /// \brief Adds a reference on behalf of an output copied from one already holding the entry.
+  static auto retain(LogStreamEntry* pEntry) noexcept -> void {
+    if (pEntry != nullptr) {
+      pEntry->refs.fetch_add(1u, std::memory_order_relaxed);
+    }
+  }
+
+  static auto release(LogStreamEntry* pEntry) noexcept -> void {
+    if (pEntry != nullptr) {
+      pEntry->refs.fetch_sub(1u, std::memory_order_release);
+    }
+  }
+
+
+private:
+  using Table = vector<std::atomic<LogStreamEntry*>>;
+
+  static auto slotOf(Table const& table, ostream const* pOut) noexcept -> Size {
+    auto hash = static_cast<uint64>(reinterpret_cast<std::uintptr_t>(pOut)) * 0x9E3779B97F4A7C15ull;
+    return static_cast<Size>(hash ^ (hash >> 32u)) & (table.size() - 1u);
+  }
+
+  /// \brief Takes a reference on an entry that is live and still registered for the given stream.
+  static auto retain(LogStreamEntry* pEntry, ostream const* pOut) noexcept -> bool {
+    auto refs = pEntry->refs.load(std::memory_order_relaxed);
+    while (refs != 0u) {
+      if (pEntry->refs.compare_exchange_weak(refs, refs + 1u, std::memory_order_acquire, std::memory_order_relaxed)) {
+        if (pEntry->out.load(std::memory_order_relaxed) == pOut) {
+          return true;
+        }
+
+        // Recycled for another stream between the probe and the CAS
+        release(pEntry);
+        return false;
+      }
+    }
+    return false;
+  }
+
+  static auto find(Table const& table, ostream const* pOut) noexcept -> LogStreamEntry* {
+    for (auto index = slotOf(table, pOut);; index = (index + 1u) & (table.size() - 1u)) {
+      auto* pEntry = table[index].load(std::memory_order_acquire);
+      if (pEntry == nullptr) {
+        return nullptr;
+      }
+
+      if (pEntry->out.load(std::memory_order_relaxed) == pOut && retain(pEntry, pOut)) {
+        return pEntry;
+      }
+    }
+  }
+
+  static auto claim(LogStreamEntry* pEntry, ostream* pOut) noexcept -> LogStreamEntry* {
+    pEntry->out.store(pOut, std::memory_order_relaxed);
+    pEntry->colourCapable = colourCompatibleOutput(*pOut);
+    pEntry->unflushed = false;
+    pEntry->lastFlush = {};
+    pEntry->refs.store(1u, std::memory_order_release);
+    return pEntry;
+  }
+
+  auto allocate() noexcept(false) -> LogStreamEntry* {
+    if (!_unused.empty()) {
+      auto* pEntry = _unused.back();
+      _unused.pop_back();
+      return pEntry;
+    }
+    return _entries.emplace_back(makeUnique<LogStreamEntry>()).get();
   }
-  out << "[";
-  if (optionEnabled(LogOptionFlagBits::InfoPrefix)) {
-    out << "logger = ";
+
+  auto insert(Table& table, LogStreamEntry* pEntry) noexcept -> LogStreamEntry* {
+    auto index = slotOf(table, pEntry->out.load(std::memory_order_relaxed));
+    while (table[index].load(std::memory_order_relaxed) != nullptr) {
+      index = (index + 1u) & (table.size() - 1u);
+    }
+    table[index].store(pEntry, std::memory_order_release);
+    ++_used;
+    return pEntry;
+  }
+
+  /// \brief Drops unreferenced entries, in place unless live entries fill half the table. Readers probing meanwhile
+  /// may miss a stream and fall back to the locked path, which is always correct.
+  auto rebuild() noexcept(false) -> Table* {
+    auto* pTable = _pTable.load(std::memory_order_relaxed);
+    vector<LogStreamEntry*> live;
+    for (auto& slot : *pTable) {
+      if (auto* pEntry = slot.load(std::memory_order_relaxed); pEntry != nullptr) {
+        if (pEntry->refs.load(std::memory_order_acquire) != 0u) {
+          live.push_back(pEntry);
+        } else {
+          pEntry->out.store(nullptr, std::memory_order_relaxed);
+          _unused.push_back(pEntry);
+        }
+      }
+    }
+
+    if ((live.size() + 1u) * 2u > pTable->size()) {
+      pTable = _tables.emplace_back(makeUnique<Table>(pTable->size() * 2u)).get();
+    } else {
+      for (auto& slot : *pTable) {
+        slot.store(nullptr, std::memory_order_relaxed);
+      }
+    }
+
+    _used = 0u;
+    for (auto* pEntry : live) {
+      (void) insert(*pTable, pEntry);
+    }
+    _pTable.store(pTable, std::memory_order_release);
+    return pTable;
   }
-  out << name() << "]";
+
+  static constexpr Size const initialCapacity = 64u;
+
+  vector<UniquePointer<Table>> _tables;
+  vector<UniquePointer<LogStreamEntry>> _entries;
+  vector<LogStreamEntry*> _unused;
+  std::atomic<Table*> _pTable {nullptr};
+  Size _used {0u};
+  Mutex _lock;
+};
+
+template <typename = LoggingEnabled> class LoggerContainer {};
+
+template <> class LoggerContainer<BoolConstant<false>> {
+public:
+  [[nodiscard]] [[maybe_unused]] auto& defaultOut() const noexcept {
+    (void) this;
+    return cout;
+  }
+
+  [[maybe_unused]] auto setDefaultOut(ostream const& out) const noexcept {
+    (void) this;
+    (void) out;
+  }
+
+  template <typename Factory>
+  [[maybe_unused]] auto get(StringRef name, Factory&& create, Logger& whenDisabled) const noexcept -> Logger& {
+    (void) this;
+    (void) name;
+    (void) create;
+    return whenDisabled;
+  }
+
+  [[maybe_unused]] auto reg(std::ostream& out) const noexcept {
+    return makeTuple(&out, static_cast<LogStreamEntry*>(nullptr));
+  }
+
+  [[maybe_unused]] auto configureAsync(Size capacity, LogOverflowPolicy policy) const noexcept {
+    (void) this;
+    (void) capacity;
+    (void) policy;
+  }
+
+  [[maybe_unused]] auto enqueue(Array<LoggerOutput> const& outputs, PendingRecord const& record) const noexcept {
+    (void) this;
+    (void) outputs;
+    (void) record;
+  }
+
+  [[maybe_unused]] auto enqueue(Array<LoggerOutput> const& outputs, LogHeaderPlan const& header,
+                                LogRecordFields const& fields, bool colourEnabled, LogArguments&& arguments) const
+      noexcept {
+    (void) this;
+    (void) outputs;
+    (void) header;
+    (void) fields;
+    (void) colourEnabled;
+    (void) arguments;
+  }
+
+  [[maybe_unused]] auto flush() const noexcept { (void) this; }
+
+  [[nodiscard]] [[maybe_unused]] auto dropped() const noexcept -> Size {
+    (void) this;
+    return 0u;
+  }
+};
+
+template <> class LoggerContainer<BoolConstant<true>> {
+public:
+  [[nodiscard]] auto& defaultOut() noexcept { return *_pDefaultOut; }
+  auto setDefaultOut(ostream& out) noexcept { _pDefaultOut = &out; }
+
+  /// \brief Only constructs the logger, and registers its output, when the name is not known yet.
+  template <typename Factory>
+  auto get(StringRef name, Factory&& create, Logger const& whenDisabled) noexcept -> Logger& {
+    (void) whenDisabled;
+    return _loggers.get(name, std::forward<Factory>(create));
+  }
+
+  auto reg(std::ostream& out) noexcept { return makeTuple(&out, _streams.acquire(out)); }
+
+  auto enqueue(Array<LoggerOutput> const& outputs, PendingRecord const& record) -> void {
+    async().push(outputs, record);
+  }
+
+  auto enqueue(Array<LoggerOutput> const& outputs, LogHeaderPlan const& header, LogRecordFields const& fields,
+               bool colourEnabled, LogArguments&& arguments) -> void {
+    async().push(outputs, header, fields, colourEnabled, std::move(arguments));
+  }
+
+  auto configureAsync(Size capacity, LogOverflowPolicy policy) noexcept(false) {
+    Lock lock(masterLock);
+    _asyncCapacity = capacity;
+    _asyncPolicy = policy;
+    _pAsync.store(nullptr, std::memory_order_release);
+    _async.reset();
+  }
+
+  auto flush() const noexcept {
+    if (auto const* pAsync = _pAsync.load(std::memory_order_acquire); pAsync != nullptr) {
+      pAsync->flush();
+    }
+  }
+
+  [[nodiscard]] auto dropped() const noexcept -> Size {
+    auto const* pAsync = _pAsync.load(std::memory_order_acquire);
+    return pAsync == nullptr ? 0u : pAsync->dropped();
+  }
+
+private:
+  auto async() noexcept(false) -> AsyncFlusher& {
+    if (auto* pAsync = _pAsync.load(std::memory_order_acquire); pAsync != nullptr) {
+      return *pAsync;
+    }
+
+    Lock lock(masterLock);
+    if (!_async) {
+      _async = makeUnique<AsyncFlusher>(_asyncCapacity, _asyncPolicy);
+      _pAsync.store(_async.get(), std::memory_order_release);
+    }
+    return *_async;
+  }
+
+  static constexpr Size const defaultAsyncCapacity = 8192u;
+
+  ostream* _pDefaultOut {&cout};
+  // Declared first, so it outlives the outputs of the loggers below
+  StreamRegistry _streams;
+  LoggerTable _loggers;
+  Mutex masterLock;
+
+  Size _asyncCapacity {defaultAsyncCapacity};
+  LogOverflowPolicy _asyncPolicy {LogOverflowPolicy::Block};
+  UniquePointer<AsyncFlusher> _async;
+  std::atomic<AsyncFlusher*> _pAsync {nullptr};
+};
+
+auto& container() noexcept {
+  using C = LoggerContainer<>;
+  static auto const container = makeUnique<C>();
+  return *container;
 }
+} // namespace
 
-auto LoggerImpl<BoolConstant<true>>::addLevel(ostream& out, Level level) const -> void {
-  if (!optionEnabled(LogOptionFlagBits::LogLevel)) {
-    return;
+namespace age {
+namespace meta {
+auto LogHeaderPlan::render(ostream& out, LogRecordFields const& fields) const -> void {
+  for (Size index = 0u; index < _stepCount; ++index) {
+    auto const& step = _steps[index];
+    switch (step.segment) {
+      case Segment::Text: out.write(_text + step.offset, step.length); break;
+      case Segment::File: writeText(out, fields.file); break;
+      case Segment::Function: writeText(out, fields.function); break;
+      case Segment::Line: writeInteger(out, fields.line); break;
+      case Segment::Column: writeInteger(out, fields.column); break;
+      case Segment::WallClock: writeText(out, timestampCache().wallClock(fields.timestamp, step.length)); break;
+      case Segment::Monotonic: writeText(out, timestampCache().monotonic(fields.timestamp, step.length)); break;
+      case Segment::Name: writeText(out, fields.name); break;
+      case Segment::Level: out << toString(fields.level); break;
+      case Segment::ThreadId: writeInteger(out, fields.threadId, 16); break;
+    }
   }
-  out << "[";
-  if (optionEnabled(LogOptionFlagBits::InfoPrefix)) {
-    out << "level = ";
+}
+
+auto formatLogHeader(ostream& out, LogOptionFlags options, LogRecordFields const& fields) -> void {
+  LogHeaderPlan(options).render(out, fields);
+}
+
+auto LoggerImpl<BoolConstant<true>>::captureFields(LogRecordFields& fields, source_location const& where,
+                                                   Level level) const noexcept -> void {
+  fields.file = where.file_name();
+  fields.function = where.function_name();
+  fields.line = where.line();
+  fields.column = where.column();
+  fields.name = name();
+  fields.level = level;
+  if (optionEnabled(LogOptionFlagBits::Timestamp)) {
+    fields.timestamp = captureTimestamp(_options);
+  }
+  if (optionEnabled(LogOptionFlagBits::ThreadId)) {
+    fields.threadId = static_cast<uint64>(Thread::currentThreadID());
+  }
+}
+
+auto LoggerImpl<BoolConstant<true>>::_header(std::ostream& out, LogRecordFields& fields, source_location const& where,
+                                             Level level) const -> void {
+  captureFields(fields, where, level);
+  if (formatsText(level)) {
+    _headerPlan.render(out, fields);
   }
-  out << toString(level) << "]";
 }
 
-auto LoggerImpl<BoolConstant<true>>::addThreadId(ostream& out) const -> void {
-  if (!optionEnabled(LogOptionFlagBits::ThreadId)) {
+auto LoggerImpl<BoolConstant<true>>::defer(Level level, source_location const& where, LogArguments&& arguments)
+    -> void {
+  LogRecordFields fields;
+  captureFields(fields, where, level);
+  container().enqueue(std::as_const(*this).outputs(), _headerPlan, fields,
+                      optionEnabled(LogOptionFlagBits::OutputTerminalColour), std::move(arguments));
+}
+
+auto LoggerImpl<BoolConstant<true>>::_footer(StringRef contents, Size bodyOffset, LogRecordFields const& fields)
+    -> void {
+  auto const& targets = std::as_const(*this).outputs();
+  auto const binary = [&fields](LoggerOutput const& output) {
+    return output.format() == LogOutputFormat::Binary && output.allows(fields.level);
+  };
+
+  PendingRecord record {contents, {}, 0u, fields.level, optionEnabled(LogOptionFlagBits::OutputTerminalColour)};
+  if (std::any_of(targets.begin(), targets.end(), binary)) {
+    auto& scratch = binaryScratch();
+    scratch.clear();
+    record.site = internLogSite(fields);
+    encodeLogRecord(scratch, record.site, _options, fields, contents.sub(bodyOffset));
+    record.encoded = scratch;
+  }
+
+  if (optionEnabled(LogOptionFlagBits::Asynchronous)) {
+    container().enqueue(targets, record);
     return;
   }
-  out << "[";
-  if (optionEnabled(LogOptionFlagBits::InfoPrefix)) {
-    out << "thread = ";
+
+  RecordFanOut fanOut {record};
+  for (auto const& output : targets) {
+    if (output.allows(fields.level)) {
+      (void) fanOut.write(output, FlushPolicy::WhenDue);
+    }
   }
-#if CI_FORMAT_AVAILABLE
-  out << std::format("0x{:x}]", Thread::currentThreadID());
-#else
-  out << "0x" << std::hex << Thread::currentThreadID() << std::dec << "]";
-#endif
 }
 
-auto LoggerImpl<BoolConstant<true>>::addHeaderSpacing(std::ostream& out) const -> void {
-  using enum age::meta::LogOptionFlagBits;
+auto LoggerImpl<BoolConstant<true>>::setRateLimit(uint32 records, chrono::milliseconds window) -> void {
+  _throttleConfig.rateLimit = records;
+  _throttleConfig.window = window;
+  if (_throttle.get() == nullptr) {
+    _throttle = makeShared<LogThrottle>();
+  }
+}
 
-  if (constexpr auto const visibleOptionsMask = InfoPrefix | SourceLocation | SourceLocationFile
-          | SourceLocationFunction | SourceLocationLine | SourceLocationColumn | Timestamp | LoggerName | LogLevel
-          | ThreadId;
-      (visibleOptionsMask & _options) == 0u) {
-    return;
+auto LoggerImpl<BoolConstant<true>>::setSampling(uint32 oneIn) -> void {
+  _throttleConfig.sampleEvery = std::max(oneIn, 1u);
+  if (_throttle.get() == nullptr) {
+    _throttle = makeShared<LogThrottle>();
   }
-  out << " ";
+}
+
+auto LoggerImpl<BoolConstant<true>>::_admit(source_location const& where, uint64& suppressed) noexcept -> bool {
+  auto const scoped = [this](LogOptionFlagBits rateLimit, LogOptionFlagBits sample) {
+    return LogThrottleConfig {optionEnabled(rateLimit) ? _throttleConfig.rateLimit : 0u, _throttleConfig.window,
+                              optionEnabled(sample) ? _throttleConfig.sampleEvery : 1u};
+  };
+
+  auto const now = throttleClock();
+  auto const siteConfig = scoped(LogOptionFlagBits::RateLimitSite, LogOptionFlagBits::SampleSite);
+  auto const loggerConfig = scoped(LogOptionFlagBits::RateLimitLogger, LogOptionFlagBits::SampleLogger);
+  auto* const pSite = siteConfig.rateLimit != 0u || siteConfig.sampleEvery > 1u ? siteThrottle(where) : nullptr;
+  auto* const pLogger = loggerConfig.rateLimit != 0u || loggerConfig.sampleEvery > 1u ? _throttle.get() : nullptr;
+
+  // A record dropped by its call site does not consume the budget of the whole logger
+  auto const admitted = (pSite == nullptr || pSite->admit(siteConfig, now))
+      && (pLogger == nullptr || pLogger->admit(loggerConfig, now));
+
+  // Suppressed records take due reports too, so that a site logging past its budget keeps reporting once per window
+  suppressed = (pSite != nullptr ? pSite->report(siteConfig, now) : 0u)
+      + (pLogger != nullptr ? pLogger->report(loggerConfig, now) : 0u);
+  return admitted;
 }
 } // namespace meta
 
@@ -300,7 +953,7 @@ auto Logger::get() noexcept -> Logger { return Logger {"anonymous_logger", conta
 
 auto Logger::get(StringRef name) noexcept -> Logger& {
   static auto whenDisabled = get();
-  return container().get(Logger {name, container().defaultOut()}, whenDisabled);
+  return container().get(name, [name] { return Logger {name, container().defaultOut()}; }, whenDisabled);
 }
 
 auto Logger::get(ostream& out) noexcept -> Logger {
@@ -308,6 +961,7 @@ auto Logger::get(ostream& out) noexcept -> Logger {
   auto& outArr = logger.outputs();
   outArr.clear();
   outArr.emplace(out);
+  logger.refreshAcceptedLevels();
   return logger;
 }
 
@@ -315,20 +969,92 @@ auto Logger::get(StringRef name, ostream& out) noexcept -> Logger& {
   auto& logger = get(name);
   auto& outArr = logger.outputs();
 
-  if (outArr.size() == 1u && &outArr[0u].outData().output() == &defaultOutput()) {
+  if (outArr.size() == 1u && outArr[0u].writesTo(defaultOutput())) {
     outArr.clear();
   }
 
   outArr.emplace(out);
+  logger.refreshAcceptedLevels();
   return logger;
 }
 
 auto Logger::setDefaultOutput(ostream& out) noexcept -> void { container().setDefaultOut(out); }
 auto Logger::defaultOutput() noexcept -> ostream& { return container().defaultOut(); }
 
+auto Logger::configureAsync(Size capacity, OverflowPolicy policy) noexcept(false) -> void {
+  container().configureAsync(capacity, policy);
+}
+
+auto Logger::reportSuppressed(Level level, source_location const& location, uint64 suppressed) noexcept -> void {
+  LogWriter {this, level, location} << "suppressed " << suppressed << " records";
+}
+
+auto Logger::flush() noexcept -> void { container().flush(); }
+auto Logger::droppedRecords() noexcept -> Size { return container().dropped(); }
+
 LoggerOutput::LoggerOutput(std::ostream& out, FilterFlags filterFlags) noexcept :
-    _out(container().reg(out)), _filter(filterFlags & mask) {}
+    _out(container().reg(out)), _filter(filterFlags & mask) {
+  if constexpr (LoggingEnabled::value) {
+    _colourCapable = _out.get<1>()->colourCapable;
+  }
+}
+
+LoggerOutput::LoggerOutput(FlightRecorder& recorder, FilterFlags filterFlags) noexcept :
+    _out(makeTuple(static_cast<ostream*>(nullptr), static_cast<LogStreamEntry*>(nullptr))),
+    _filter(filterFlags & mask), _format(LogOutputFormat::Recorder), _pRecorder(&recorder) {}
+
+LoggerOutput::LoggerOutput(LoggerOutput const& output) noexcept :
+    _out(output._out), _filter(output._filter), _format(output._format), _colourCapable(output._colourCapable),
+    _pRecorder(output._pRecorder) {
+  if constexpr (LoggingEnabled::value) {
+    StreamRegistry::retain(_out.get<1>());
+  }
+}
+
+LoggerOutput::LoggerOutput(LoggerOutput&& output) noexcept :
+    _out(output._out), _filter(output._filter), _format(output._format), _colourCapable(output._colourCapable),
+    _pRecorder(output._pRecorder) {
+  output._out.get<1>() = nullptr;
+}
+
+LoggerOutput::~LoggerOutput() noexcept {
+  if constexpr (LoggingEnabled::value) {
+    StreamRegistry::release(_out.get<1>());
+  }
+}
+
+auto LoggerOutput::operator=(LoggerOutput const& output) noexcept -> LoggerOutput& {
+  if (this != &output) {
+    if constexpr (LoggingEnabled::value) {
+      StreamRegistry::retain(output._out.get<1>());
+      StreamRegistry::release(_out.get<1>());
+    }
+
+    _out = output._out;
+    _filter = output._filter;
+    _format = output._format;
+    _colourCapable = output._colourCapable;
+    _pRecorder = output._pRecorder;
+  }
+  return *this;
+}
+
+auto LoggerOutput::operator=(LoggerOutput&& output) noexcept -> LoggerOutput& {
+  if (this != &output) {
+    if constexpr (LoggingEnabled::value) {
+      StreamRegistry::release(_out.get<1>());
+    }
+
+    _out = output._out;
+    _filter = output._filter;
+    _format = output._format;
+    _colourCapable = output._colourCapable;
+    _pRecorder = output._pRecorder;
+    output._out.get<1>() = nullptr;
+  }
+  return *this;
+}
 
-LoggerOutput::LockedOutput::LockedOutput(OutData& out) : _out(out) { LockConfig<>::lock(_out.get<1>()); }
+LoggerOutput::LockedOutput::LockedOutput(OutData const& out) : _out(out) { LockConfig<>::lock(_out.get<1>()); }
 LoggerOutput::LockedOutput::~LockedOutput() { LockConfig<>::unlock(_out.get<1>()); }
 } // namespace age
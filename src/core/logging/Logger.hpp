@@ -6,15 +6,24 @@
 
 #include <CDS/Array>
 #include <CDS/Tuple>
+#include <CDS/memory/SharedPointer>
 #include <CDS/memory/UniquePointer>
 #include <CDS/threading/Mutex>
 
+#include <initializer_list>
 #include <source_location>
+#include <string_view>
+#include <utility>
 
 #include <lang/flag/FlagEnum.hpp>
 #include <lang/string/StringRef.hpp>
+#include <logging/LogBuffer.hpp>
+#include <logging/LogFormat.hpp>
+#include <logging/LogQueue.hpp>
+#include <logging/LogThrottle.hpp>
 
 namespace age {
+class FlightRecorder;
 class Logger;
 
 namespace meta {
@@ -22,12 +31,21 @@ enum class LogLevelFlagBits : cds::uint32 { Info = 1u << 0, Debug = 1u << 1, Err
 enum class LogOptionFlagBits : cds::uint32 {
   OutputTerminalColour = 1u << 0,
   InfoPrefix = 1u << 1,
+  Asynchronous = 1u << 2,
+  RateLimitSite = 1u << 3,
+  RateLimitLogger = 1u << 4,
+  SampleSite = 1u << 5,
+  SampleLogger = 1u << 6,
   SourceLocation = 1u << 8,
   SourceLocationFile = 1u << 9,
   SourceLocationFunction = 1u << 10,
   SourceLocationLine = 1u << 11,
   SourceLocationColumn = 1u << 12,
   Timestamp = 1u << 16,
+  TimestampMilliseconds = 1u << 17,
+  TimestampMicroseconds = 1u << 18,
+  TimestampNanoseconds = 1u << 19,
+  MonotonicTimestamp = 1u << 20,
   LoggerName = 1u << 24,
   LogLevel = 1u << 25,
   ThreadId = 1u << 26,
@@ -48,10 +66,148 @@ static constexpr auto const logLevelMask =
     LogLevelFlagBits::Info | LogLevelFlagBits::Debug | LogLevelFlagBits::Warning | LogLevelFlagBits::Error;
 
 static constexpr auto const logOptionsMask = LogOptionFlagBits::OutputTerminalColour | LogOptionFlagBits::InfoPrefix
-    | LogOptionFlagBits::SourceLocation | LogOptionFlagBits::SourceLocationFile
-    | LogOptionFlagBits::SourceLocationFunction | LogOptionFlagBits::SourceLocationLine
-    | LogOptionFlagBits::SourceLocationColumn | LogOptionFlagBits::Timestamp | LogOptionFlagBits::LoggerName
+    | LogOptionFlagBits::Asynchronous | LogOptionFlagBits::RateLimitSite | LogOptionFlagBits::RateLimitLogger
+    | LogOptionFlagBits::SampleSite | LogOptionFlagBits::SampleLogger | LogOptionFlagBits::SourceLocation
+    | LogOptionFlagBits::SourceLocationFile | LogOptionFlagBits::SourceLocationFunction
+    | LogOptionFlagBits::SourceLocationLine | LogOptionFlagBits::SourceLocationColumn | LogOptionFlagBits::Timestamp
+    | LogOptionFlagBits::TimestampMilliseconds | LogOptionFlagBits::TimestampMicroseconds
+    | LogOptionFlagBits::TimestampNanoseconds | LogOptionFlagBits::MonotonicTimestamp | LogOptionFlagBits::LoggerName
     | LogOptionFlagBits::LogLevel | LogOptionFlagBits::ThreadId;
+
+/// \brief Text outputs receive the formatted record, Binary outputs receive the compact encoding described in
+/// BinaryLogFormat.hpp, to be rendered later by age-logdecode. Recorder outputs keep the formatted record in a
+/// FlightRecorder instead of a stream.
+enum class LogOutputFormat : cds::uint32 { Text, Binary, Recorder };
+
+/// \brief Header values of a single record, captured when the record starts.
+/// Timestamp is in nanoseconds: since the system clock epoch, or since startup with MonotonicTimestamp.
+struct LogRecordFields {
+  StringRef file;
+  StringRef function;
+  cds::uint32 line {0u};
+  cds::uint32 column {0u};
+  StringRef name;
+  LogLevelFlagBits level {LogLevelFlagBits::Info};
+  cds::sint64 timestamp {0};
+  cds::uint64 threadId {0u};
+};
+
+/// \brief Text header layout of one set of options, compiled into a sequence of literal and field segments when the
+/// options change. Rendering a record then emits the segments in order without testing any option.
+class LogHeaderPlan {
+public:
+  constexpr LogHeaderPlan() noexcept = default;
+
+  constexpr explicit LogHeaderPlan(LogOptionFlags options) noexcept {
+    using enum LogOptionFlagBits;
+    auto const has = [options](LogOptionFlagBits option) { return (options & option) != 0u; };
+    auto const prefixed = [&has](std::string_view prefix) { return has(InfoPrefix) ? prefix : std::string_view {}; };
+
+    if (has(SourceLocation)
+        && (options & (SourceLocationFile | SourceLocationFunction | SourceLocationLine | SourceLocationColumn)) != 0u) {
+      auto separated = false;
+      text("[");
+      for (auto [flag, segment] : {std::pair {SourceLocationFile, Segment::File},
+                                   std::pair {SourceLocationFunction, Segment::Function},
+                                   std::pair {SourceLocationLine, Segment::Line},
+                                   std::pair {SourceLocationColumn, Segment::Column}}) {
+        if (has(flag)) {
+          text(separated ? ":" : "");
+          field(segment);
+          separated = true;
+        }
+      }
+      text("]");
+    }
+
+    if (has(Timestamp)) {
+      auto const digits = has(TimestampNanoseconds)    ? 9u
+                          : has(TimestampMicroseconds) ? 6u
+                          : has(TimestampMilliseconds) ? 3u
+                                                       : 0u;
+      text("[");
+      text(prefixed("time = "));
+      field(has(MonotonicTimestamp) ? Segment::Monotonic : Segment::WallClock, static_cast<cds::uint8>(digits));
+      text("]");
+    }
+
+    if (has(LoggerName)) {
+      text("[");
+      text(prefixed("logger = "));
+      field(Segment::Name);
+      text("]");
+    }
+
+    if (has(LogLevel)) {
+      text("[");
+      text(prefixed("level = "));
+      field(Segment::Level);
+      text("]");
+    }
+
+    if (has(ThreadId)) {
+      text("[");
+      text(prefixed("thread = "));
+      text("0x");
+      field(Segment::ThreadId);
+      text("]");
+    }
+
+    if (constexpr auto const visibleOptionsMask = InfoPrefix | SourceLocation | SourceLocationFile
+            | SourceLocationFunction | SourceLocationLine | SourceLocationColumn | Timestamp | LoggerName | LogLevel
+            | ThreadId;
+        (options & visibleOptionsMask) != 0u) {
+      text(" ");
+    }
+  }
+
+  /// \brief Writes the header of a record. Timestamps are formatted through the calling thread's timestamp cache.
+  auto render(std::ostream& out, LogRecordFields const& fields) const -> void;
+
+private:
+  enum class Segment : cds::uint8 { Text, File, Function, Line, Column, WallClock, Monotonic, Name, Level, ThreadId };
+
+  /// \brief A field, or, for Text segments, the range [offset, offset + length) of the literal text. Timestamps keep
+  /// their sub-second digit count in length.
+  struct Step {
+    Segment segment {Segment::Text};
+    cds::uint8 offset {0u};
+    cds::uint8 length {0u};
+  };
+
+  /// \brief Appends literal text, merging it into the previous segment when that is text as well.
+  constexpr auto text(std::string_view literal) noexcept -> void {
+    if (literal.empty()) {
+      return;
+    }
+
+    if (_stepCount == 0u || _steps[_stepCount - 1u].segment != Segment::Text) {
+      _steps[_stepCount++] = {Segment::Text, _textLength, 0u};
+    }
+    for (auto character : literal) {
+      _text[_textLength++] = character;
+    }
+    _steps[_stepCount - 1u].length += static_cast<cds::uint8>(literal.size());
+  }
+
+  constexpr auto field(Segment segment, cds::uint8 length = 0u) noexcept -> void {
+    _steps[_stepCount++] = {segment, 0u, length};
+  }
+
+  // Bounded by the longest layout: every field enabled and prefixed
+  static constexpr cds::Size const textCapacity = 64u;
+  static constexpr cds::Size const stepCapacity = 20u;
+
+  char _text[textCapacity] {};
+  Step _steps[stepCapacity] {};
+  cds::uint8 _textLength {0u};
+  cds::uint8 _stepCount {0u};
+};
+
+/// \brief Writes the text header of a record, as laid out for the given options.
+auto formatLogHeader(std::ostream& out, LogOptionFlags options, LogRecordFields const& fields) -> void;
+
+struct LogStreamEntry;
 } // namespace meta
 
 class LoggerOutput {
@@ -70,11 +226,25 @@ public:
   LoggerOutput(std::ostream& out, FilterFlagBits filterLevel) noexcept :
       LoggerOutput(out, static_cast<FilterFlags>(filterLevel)) {}
 
-  LoggerOutput(LoggerOutput const& output) noexcept = default;
-  LoggerOutput(LoggerOutput&& output) noexcept : _out(std::move(output._out)), _filter(output._filter) {}
-  ~LoggerOutput() noexcept = default;
+  LoggerOutput(std::ostream& out, FilterFlags filterFlags, meta::LogOutputFormat format) noexcept :
+      LoggerOutput(out, filterFlags) {
+    _format = format;
+  }
+
+  explicit(false) LoggerOutput(FlightRecorder& recorder, FilterFlags filterFlags = allowAll) noexcept;
+
+  LoggerOutput(LoggerOutput const& output) noexcept;
+  LoggerOutput(LoggerOutput&& output) noexcept;
+  ~LoggerOutput() noexcept;
+
+  auto operator=(LoggerOutput const& output) noexcept -> LoggerOutput&;
+  auto operator=(LoggerOutput&& output) noexcept -> LoggerOutput&;
+
+  [[nodiscard]] static auto binary(std::ostream& out, FilterFlags filterFlags = allowAll) noexcept {
+    return LoggerOutput(out, filterFlags, meta::LogOutputFormat::Binary);
+  }
 
-  [[nodiscard]] auto outData() noexcept { return LockedOutput(_out); }
+  [[nodiscard]] auto outData() const noexcept { return LockedOutput(_out); }
 
   [[nodiscard]] constexpr auto allows(meta::LogLevelFlags levels) const noexcept {
     assert((levels == (levels & mask)) && "Level requested outside valid Log Level values");
@@ -85,24 +255,35 @@ public:
     return allows(static_cast<meta::LogLevelFlags>(level));
   }
 
+  [[nodiscard]] constexpr auto filter() const noexcept { return _filter; }
+  [[nodiscard]] constexpr auto format() const noexcept { return _format; }
+  [[nodiscard]] constexpr auto recorder() const noexcept { return _pRecorder; }
+  [[nodiscard]] auto writesTo(std::ostream const& out) const noexcept { return _out.get<0>() == &out; }
+  /// \brief Whether the stream is a terminal accepting colour codes, detected once when the stream was registered.
+  [[nodiscard]] constexpr auto colourCapable() const noexcept { return _colourCapable; }
+
 private:
-  using OutData = cds::Tuple<std::ostream*, cds::Mutex*>;
+  using OutData = cds::Tuple<std::ostream*, meta::LogStreamEntry*>;
 
   class LockedOutput {
   public:
-    explicit LockedOutput(OutData& out);
+    explicit LockedOutput(OutData const& out);
     LockedOutput(LockedOutput const&) = delete;
     LockedOutput(LockedOutput&&) = delete;
     ~LockedOutput();
 
     [[nodiscard]] constexpr auto& output() noexcept { return *_out.get<0>(); }
+    [[nodiscard]] constexpr auto* entry() noexcept { return _out.get<1>(); }
 
   private:
-    OutData& _out;
+    OutData const& _out;
   };
 
   OutData _out;
   FilterFlags _filter;
+  meta::LogOutputFormat _format {meta::LogOutputFormat::Text};
+  bool _colourCapable {false};
+  FlightRecorder* _pRecorder {nullptr};
   static constexpr auto const mask = meta::logLevelMask;
 };
 
@@ -113,6 +294,40 @@ using LoggingEnabled = cds::meta::BoolConstant<false>;
 using LoggingEnabled = cds::meta::BoolConstant<true>;
 #endif
 
+#ifndef AGE_LOG_MINIMUM_LEVEL
+#define AGE_LOG_MINIMUM_LEVEL Debug
+#endif
+
+/// \brief Lowest level compiled into logging-enabled builds, set at configuration with -DAGE_LOG_MINIMUM_LEVEL to one of
+/// Debug, Info, Warning or Error. Records below it get an inactive writer, which folds to dead code when the level is
+/// known at the call site.
+constexpr auto const compiledMinimumLevel = LogLevelFlagBits::AGE_LOG_MINIMUM_LEVEL;
+
+[[nodiscard]] constexpr auto severity(LogLevelFlagBits level) noexcept -> cds::uint32 {
+  switch (level) {
+    using enum LogLevelFlagBits;
+    case Debug: return 0u;
+    case Info: return 1u;
+    case Warning: return 2u;
+    case Error: return 3u;
+  }
+  return 0u;
+}
+
+/// \brief Returns the levels at least as severe as the given one.
+[[nodiscard]] constexpr auto levelsFrom(LogLevelFlagBits minimum) noexcept -> LogLevelFlags {
+  using enum LogLevelFlagBits;
+  LogLevelFlags levels = 0u;
+  for (auto level : {Debug, Info, Warning, Error}) {
+    if (severity(level) >= severity(minimum)) {
+      levels |= level;
+    }
+  }
+  return levels;
+}
+
+constexpr auto const compiledLogLevels = LoggingEnabled::value ? levelsFrom(compiledMinimumLevel) : LogLevelFlags {0u};
+
 class LoggerImplBase {
 public:
   static constexpr auto const defaultOptionFlags = LogOptionFlagBits::OutputTerminalColour
@@ -125,12 +340,62 @@ protected:
   using OptionFlag = LogOptionFlagBits;
 
   LoggerImplBase() noexcept = default;
-  explicit LoggerImplBase(LoggerOutput const& out) noexcept : _outputs(1u, out) {}
-  auto& outputs() noexcept { return _outputs; }
+  explicit LoggerImplBase(LoggerOutput const& out) noexcept : _outputs(1u, out) { refreshAcceptedLevels(); }
+
+  /// \brief Mutable access may change the output filters, so the cached accepted levels fall back to every level
+  /// below the threshold until refreshAcceptedLevels is called.
+  auto& outputs() noexcept {
+    _acceptedLevels = _thresholdLevels;
+    _textLevels = _thresholdLevels;
+    _binaryLevels = _thresholdLevels;
+    return _outputs;
+  }
+
   [[nodiscard]] auto const& outputs() const noexcept { return _outputs; }
 
+  /// \brief Whether any output of this logger can receive a record of the given level.
+  [[nodiscard]] constexpr auto accepts(LogLevelFlagBits level) const noexcept {
+    return (_acceptedLevels & level) != 0u;
+  }
+
+  /// \brief Whether a record of the given level needs its text header, i.e. reaches a Text output.
+  [[nodiscard]] constexpr auto formatsText(LogLevelFlagBits level) const noexcept {
+    return (_textLevels & level) != 0u;
+  }
+
+  /// \brief Whether a record of the given level may reach a Binary output, which needs its body when logged.
+  [[nodiscard]] constexpr auto encodesBinary(LogLevelFlagBits level) const noexcept {
+    return (_binaryLevels & level) != 0u;
+  }
+
+  auto refreshAcceptedLevels() noexcept -> void {
+    LogLevelFlags levels = 0u;
+    LogLevelFlags textLevels = 0u;
+    LogLevelFlags binaryLevels = 0u;
+    for (auto const& output : _outputs) {
+      levels |= output.filter();
+      if (output.format() == LogOutputFormat::Binary) {
+        binaryLevels |= output.filter();
+      } else {
+        textLevels |= output.filter();
+      }
+    }
+    _acceptedLevels = levels & _thresholdLevels;
+    _textLevels = textLevels & _thresholdLevels;
+    _binaryLevels = binaryLevels & _thresholdLevels;
+  }
+
+  auto setThresholdLevels(LogLevelFlags levels) noexcept -> void {
+    _thresholdLevels = levels;
+    refreshAcceptedLevels();
+  }
+
 private:
   cds::Array<LoggerOutput> _outputs;
+  LogLevelFlags _thresholdLevels {logLevelMask};
+  LogLevelFlags _acceptedLevels {0u};
+  LogLevelFlags _textLevels {0u};
+  LogLevelFlags _binaryLevels {0u};
 };
 
 template <typename = LoggingEnabled> class LoggerImpl {};
@@ -157,6 +422,42 @@ protected:
     (void) level;
   }
 
+  auto setMinimumLevel(Level level) const noexcept {
+    (void) this;
+    (void) level;
+  }
+
+  auto setRateLimit(cds::uint32 records, std::chrono::milliseconds window = std::chrono::seconds(1)) const noexcept {
+    (void) this;
+    (void) records;
+    (void) window;
+  }
+
+  auto setSampling(cds::uint32 oneIn) const noexcept {
+    (void) this;
+    (void) oneIn;
+  }
+
+  constexpr auto admit(std::source_location const& where, cds::uint64& suppressed) const noexcept {
+    (void) this;
+    (void) where;
+    (void) suppressed;
+    return true;
+  }
+
+  [[nodiscard]] constexpr auto defersFormatting(Level level) const noexcept {
+    (void) this;
+    (void) level;
+    return false;
+  }
+
+  auto defer(Level level, std::source_location const& where, LogArguments&& arguments) const noexcept {
+    (void) this;
+    (void) level;
+    (void) where;
+    (void) arguments;
+  }
+
   constexpr auto enableOptions(LogOptionFlags optionFlags) const noexcept -> void {
     (void) this;
     (void) optionFlags;
@@ -187,9 +488,11 @@ protected:
     (void) optionFlag;
   }
 
-  auto header(std::ostream const& out, std::source_location const& where, Level level) const noexcept {
+  auto header(std::ostream const& out, LogRecordFields const& fields, std::source_location const& where,
+              Level level) const noexcept {
     (void) this;
     (void) out;
+    (void) fields;
     (void) where;
     (void) level;
   }
@@ -206,10 +509,11 @@ protected:
     (void) pfn;
   }
 
-  auto footer(std::string const& contents, Level level) const {
+  auto footer(StringRef contents, cds::Size bodyOffset, LogRecordFields const& fields) const {
     (void) this;
     (void) contents;
-    (void) level;
+    (void) bodyOffset;
+    (void) fields;
   }
 };
 
@@ -220,50 +524,81 @@ public:
 
   auto setDefaultLevel(Level level) noexcept { _defaultLevel = level; }
 
+  /// \brief Discards records less severe than the given level before their header is formatted.
+  auto setMinimumLevel(Level level) noexcept { setThresholdLevels(levelsFrom(level)); }
+
+  /// \brief Admits at most the given number of records per window, per call site with OptionFlag::RateLimitSite and
+  /// across the logger with OptionFlag::RateLimitLogger. Past meta::siteThrottleCapacity call sites, further sites are
+  /// only throttled across the logger. The number of suppressed records is reported at most once per window, by the
+  /// next record going through the same throttle, admitted or not.
+  auto setRateLimit(cds::uint32 records, std::chrono::milliseconds window = std::chrono::seconds(1)) -> void;
+
+  /// \brief Admits one record out of every oneIn, per call site with OptionFlag::SampleSite and across the logger with
+  /// OptionFlag::SampleLogger.
+  auto setSampling(cds::uint32 oneIn) -> void;
+
 protected:
   LoggerImpl(StringRef name, LoggerOutput&& out) noexcept : LoggerImplBase(std::move(out)), _name(name) {}
 
-  auto header(std::ostream& out, std::source_location const& where, Level level) const { _header(out, where, level); }
+  /// \brief Asynchronous records reaching only Text outputs are formatted on the flusher thread.
+  [[nodiscard]] constexpr auto defersFormatting(Level level) const noexcept -> bool {
+    return (_options & LogOptionFlagBits::Asynchronous) != 0u && !encodesBinary(level);
+  }
+
+  /// \brief Captures the header fields of a record and queues it with its unformatted arguments.
+  auto defer(Level level, std::source_location const& where, LogArguments&& arguments) -> void;
+
+  /// \brief Decides whether a record is throttled away, before anything is formatted. Whether admitted or not, suppressed
+  /// is set to the number of records dropped since the last report, when one is due.
+  [[nodiscard]] auto admit(std::source_location const& where, cds::uint64& suppressed) noexcept {
+    return (_options & throttleOptions) == 0u || _admit(where, suppressed);
+  }
+
+  auto header(std::ostream& out, LogRecordFields& fields, std::source_location const& where, Level level) const {
+    _header(out, fields, where, level);
+  }
   template <typename T> auto write(std::ostream& out, T&& data) const noexcept -> void { out << std::forward<T>(data); }
   auto modify(std::ostream& out, std::ostream& (*pfn)(std::ostream&) ) const noexcept -> void { out << pfn; }
-  auto footer(std::string const& contents, Level level) { _footer(contents, level); }
+  auto footer(StringRef contents, cds::Size bodyOffset, LogRecordFields const& fields) {
+    _footer(contents, bodyOffset, fields);
+  }
 
   constexpr auto enableOptions(LogOptionFlags optionFlags) noexcept -> void {
-    _options |= addRequirements(optionFlags & logOptionsMask);
+    applyOptions(_options | addRequirements(optionFlags & logOptionsMask));
   }
 
   constexpr auto disableOptions(LogOptionFlags optionFlags) noexcept -> void {
-    _options &= ~(removeRequirements(optionFlags & logOptionsMask));
+    applyOptions(_options & ~(removeRequirements(optionFlags & logOptionsMask)));
   }
 
   constexpr auto setOptions(LogOptionFlags optionFlags) noexcept -> void {
-    _options = addRequirements(optionFlags & logOptionsMask);
+    applyOptions(addRequirements(optionFlags & logOptionsMask));
   }
 
   constexpr auto enableOptions(LogOptionFlagBits optionFlag) noexcept -> void {
-    _options |= addRequirements(optionFlag & logOptionsMask);
+    applyOptions(_options | addRequirements(optionFlag & logOptionsMask));
   }
 
   constexpr auto disableOptions(LogOptionFlagBits optionFlag) noexcept -> void {
-    _options &= ~(removeRequirements(optionFlag & logOptionsMask));
+    applyOptions(_options & ~(removeRequirements(optionFlag & logOptionsMask)));
   }
 
   constexpr auto setOptions(LogOptionFlagBits optionFlag) noexcept -> void {
-    _options = addRequirements(optionFlag & logOptionsMask);
+    applyOptions(addRequirements(optionFlag & logOptionsMask));
   }
 
 private:
-  auto _header(std::ostream& out, std::source_location const& where, Level level) const -> void;
-  auto _footer(std::string const& contents, Level level) -> void;
-
-  auto addColourHeader(std::ostream& out, Level level) const -> void;
-  auto addEndColourMarker(std::ostream& out) const -> void;
-  auto addLocation(std::ostream& out, std::source_location const& where) const -> void;
-  auto addTimestamp(std::ostream& out, StringRef timestamp) const -> void;
-  auto addName(std::ostream& out) const -> void;
-  auto addLevel(std::ostream& out, Level level) const -> void;
-  auto addThreadId(std::ostream& out) const -> void;
-  auto addHeaderSpacing(std::ostream& out) const -> void;
+  auto _header(std::ostream& out, LogRecordFields& fields, std::source_location const& where, Level level) const
+      -> void;
+  auto captureFields(LogRecordFields& fields, std::source_location const& where, Level level) const noexcept -> void;
+  auto _footer(StringRef contents, cds::Size bodyOffset, LogRecordFields const& fields) -> void;
+  auto _admit(std::source_location const& where, cds::uint64& suppressed) noexcept -> bool;
+
+  /// \brief Recompiles the header layout, so records never look at the option bits that only affect the header.
+  constexpr auto applyOptions(LogOptionFlags options) noexcept -> void {
+    _options = options;
+    _headerPlan = LogHeaderPlan {options};
+  }
 
   static constexpr auto addRequirements(LogLevelFlags flags) noexcept -> LogLevelFlags {
     using enum age::meta::LogOptionFlagBits;
@@ -273,6 +608,10 @@ private:
       flags |= SourceLocationFile | SourceLocationLine;
     }
 
+    if ((flags & requireTimestamp) != 0u) {
+      flags |= Timestamp;
+    }
+
     return flags;
   }
 
@@ -290,10 +629,19 @@ private:
   cds::String _name;
   Level _defaultLevel = Level::Info;
   LogOptionFlags _options = defaultOptionFlags;
+  LogHeaderPlan _headerPlan {defaultOptionFlags};
+  LogThrottleConfig _throttleConfig;
+  /// \brief Shared between copies of a logger, created once a limit is configured.
+  cds::SharedPointer<LogThrottle> _throttle;
 
+  static constexpr auto const throttleOptions = LogOptionFlagBits::RateLimitSite | LogOptionFlagBits::RateLimitLogger
+      | LogOptionFlagBits::SampleSite | LogOptionFlagBits::SampleLogger;
   static constexpr auto const requireSourceLocation = LogOptionFlagBits::SourceLocationFile
       | LogOptionFlagBits::SourceLocationFunction | LogOptionFlagBits::SourceLocationLine
       | LogOptionFlagBits::SourceLocationColumn;
+  static constexpr auto const requireTimestamp = LogOptionFlagBits::TimestampMilliseconds
+      | LogOptionFlagBits::TimestampMicroseconds | LogOptionFlagBits::TimestampNanoseconds
+      | LogOptionFlagBits::MonotonicTimestamp;
 };
 } // namespace meta
 
@@ -301,13 +649,60 @@ class Logger : protected meta::LoggerImpl<> {
 public:
   using meta::LoggerImpl<>::Level;
   using meta::LoggerImpl<>::OptionFlag;
+  using OverflowPolicy = meta::LogOverflowPolicy;
 
-  auto operator()(std::source_location const& location = std::source_location::current()) noexcept {
-    return LogWriter {this, defaultLevel(), location};
+  [[nodiscard]] constexpr auto enabled(Level level) const noexcept {
+    return (meta::compiledLogLevels & level) != 0u && accepts(level);
   }
 
   auto operator()(Level level, std::source_location const& location = std::source_location::current()) noexcept {
-    return LogWriter {this, level, location};
+    cds::uint64 suppressed = 0u;
+    auto const admitted = enabled(level) && admit(location, suppressed);
+    if (suppressed != 0u) {
+      reportSuppressed(level, location, suppressed);
+    }
+    return LogWriter {admitted ? this : nullptr, level, location};
+  }
+
+  auto operator()(std::source_location const& location = std::source_location::current()) noexcept {
+    return operator()(defaultLevel(), location);
+  }
+
+  /// \brief Logs a record from a format string whose {} placeholders are checked against the arguments at compile
+  /// time, e.g. logger.info("loaded {} of {}", done, total). Filtered records never touch their arguments.
+  /// Asynchronous records keep copies of the arguments and are formatted on the flusher thread.
+  template <typename... Args> auto log(Level level, meta::LogFormat<Args...> format, Args&&... args) -> void {
+    cds::uint64 suppressed = 0u;
+    auto const admitted = enabled(level) && admit(format.location(), suppressed);
+    if (suppressed != 0u) {
+      reportSuppressed(level, format.location(), suppressed);
+    }
+
+    if (!admitted) {
+      return;
+    }
+
+    if (defersFormatting(level)) {
+      defer(level, format.location(), meta::LogArguments {format.get(), std::forward<Args>(args)...});
+    } else {
+      LogWriter {this, level, format.location()}.format(format.get(), args...);
+    }
+  }
+
+  template <typename... Args> auto debug(meta::LogFormat<Args...> format, Args&&... args) -> void {
+    log<Args...>(Level::Debug, format, std::forward<Args>(args)...);
+  }
+
+  template <typename... Args> auto info(meta::LogFormat<Args...> format, Args&&... args) -> void {
+    log<Args...>(Level::Info, format, std::forward<Args>(args)...);
+  }
+
+  template <typename... Args> auto warning(meta::LogFormat<Args...> format, Args&&... args) -> void {
+    log<Args...>(Level::Warning, format, std::forward<Args>(args)...);
+  }
+
+  template <typename... Args> auto error(meta::LogFormat<Args...> format, Args&&... args) -> void {
+    log<Args...>(Level::Error, format, std::forward<Args>(args)...);
   }
 
   template <typename... Outputs>
@@ -318,11 +713,12 @@ public:
     auto& logger = get(name);
     auto& outArr = logger.outputs();
 
-    if (outArr.size() == 1u && &outArr[0u].outData().output() == &defaultOutput()) {
+    if (outArr.size() == 1u && outArr[0u].writesTo(defaultOutput())) {
       outArr.clear();
     }
 
     outArr.insertAll(std::forward<Outputs>(outputs)...);
+    logger.refreshAcceptedLevels();
     return logger;
   }
 
@@ -335,6 +731,7 @@ public:
     auto& outArr = logger.outputs();
     outArr.clear();
     outArr.insertAll(std::forward<Outputs>(outputs)...);
+    logger.refreshAcceptedLevels();
     return logger;
   }
 
@@ -345,6 +742,14 @@ public:
   static auto setDefaultOutput(std::ostream& out) noexcept -> void;
   static auto defaultOutput() noexcept -> std::ostream&;
 
+  /// \brief Configures the queue used by loggers with OptionFlag::Asynchronous enabled. Pending records are flushed
+  /// before the new queue replaces the old one, so this must not race with asynchronous logging.
+  static auto configureAsync(cds::Size capacity, OverflowPolicy policy = OverflowPolicy::Block) noexcept(false)
+      -> void;
+  /// \brief Blocks until every asynchronous record submitted before the call was written to its outputs.
+  static auto flush() noexcept -> void;
+  [[nodiscard]] static auto droppedRecords() noexcept -> cds::Size;
+
   using meta::LoggerImpl<>::defaultOptionFlags;
 
   using meta::LoggerImpl<>::name;
@@ -353,30 +758,55 @@ public:
   using meta::LoggerImpl<>::disableOptions;
   using meta::LoggerImpl<>::setOptions;
   using meta::LoggerImpl<>::setDefaultLevel;
+  using meta::LoggerImpl<>::setMinimumLevel;
+  using meta::LoggerImpl<>::setRateLimit;
+  using meta::LoggerImpl<>::setSampling;
 
 private:
+  auto reportSuppressed(Level level, std::source_location const& location, cds::uint64 suppressed) noexcept -> void;
+
+  /// \brief Formats one record. A writer created without a logger is inactive and ignores everything streamed into it.
   class LogWriter {
   public:
-    LogWriter(Logger* pLogger, Level level, std::source_location const& location) : _pLogger(pLogger), _level(level) {
-      _pLogger->header(_localBuffer, location, level);
+    LogWriter(Logger* pLogger, Level level, std::source_location const& location) :
+        _pLogger(pLogger), _buffer(pLogger != nullptr) {
+      if (_pLogger != nullptr) {
+        _pLogger->header(_buffer.stream(), _fields, location, level);
+        _bodyOffset = _buffer.contents().size();
+      }
     }
 
     template <typename T> auto& operator<<(T&& data) {
-      _pLogger->write(_localBuffer, std::forward<T>(data));
+      if (_pLogger != nullptr) {
+        _pLogger->write(_buffer.stream(), std::forward<T>(data));
+      }
       return *this;
     }
 
     auto& operator<<(std::ostream& (*pfn)(std::ostream&) ) {
-      _pLogger->modify(_localBuffer, pfn);
+      if (_pLogger != nullptr) {
+        _pLogger->modify(_buffer.stream(), pfn);
+      }
       return *this;
     }
 
-    ~LogWriter() noexcept { _pLogger->footer(_localBuffer.str(), _level); }
+    template <typename... Args> auto format(std::string_view format, Args const&... args) -> void {
+      if (_pLogger != nullptr) {
+        meta::formatLogArguments(_buffer.stream(), format, args...);
+      }
+    }
+
+    ~LogWriter() noexcept {
+      if (_pLogger != nullptr) {
+        _pLogger->footer(_buffer.contents(), _bodyOffset, _fields);
+      }
+    }
 
   private:
     Logger* _pLogger;
-    Level _level;
-    std::stringstream _localBuffer;
+    meta::LogBufferLease _buffer;
+    meta::LogRecordFields _fields;
+    cds::Size _bodyOffset {0u};
   };
 
   using meta::LoggerImpl<>::LoggerImpl;
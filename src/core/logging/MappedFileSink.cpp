@@ -0,0 +1,237 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include "MappedFileSink.hpp"
+#include "BinaryLogFormat.hpp"
+
+#include <algorithm>
+#include <string>
+#include <system_error>
+
+#if defined(__linux) | defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define AGE_MAPPED_FILE_AVAILABLE true
+#else
+#define AGE_MAPPED_FILE_AVAILABLE false
+#endif
+
+namespace {
+using namespace age;
+using namespace cds;
+using namespace std;
+
+auto pageSize() noexcept -> Size {
+#if AGE_MAPPED_FILE_AVAILABLE
+  static auto const size = static_cast<Size>(sysconf(_SC_PAGESIZE));
+  return size;
+#else
+  return 4096u;
+#endif
+}
+
+auto roundToPages(Size size) noexcept {
+  auto const page = pageSize();
+  return std::max(page, (size + page - 1u) / page * page);
+}
+
+auto backupPath(filesystem::path const& path, Size index) {
+  auto backup = path;
+  backup += "." + to_string(index);
+  return backup;
+}
+} // namespace
+
+namespace age {
+namespace meta {
+MappedFileBuffer::MappedFileBuffer(MappedFileConfig config) noexcept : _config(std::move(config)) {
+  _config.chunkSize = roundToPages(_config.chunkSize);
+  (void) open();
+}
+
+MappedFileBuffer::~MappedFileBuffer() noexcept { close(); }
+
+auto MappedFileBuffer::written() const noexcept -> Size {
+  return _chunkOffset + static_cast<Size>(pptr() - pbase());
+}
+
+auto MappedFileBuffer::rotationDue() const noexcept -> bool {
+  if (_config.rotateSize != 0u && written() >= _config.rotateSize) {
+    return true;
+  }
+  return _config.rotateInterval.count() != 0 && chrono::steady_clock::now() - _openedAt >= _config.rotateInterval;
+}
+
+auto MappedFileBuffer::open() noexcept -> bool {
+#if AGE_MAPPED_FILE_AVAILABLE
+  error_code error;
+  if (_config.path.has_parent_path()) {
+    filesystem::create_directories(_config.path.parent_path(), error);
+  }
+
+  _descriptor = ::open(_config.path.c_str(), O_RDWR | O_CREAT, 0644);
+  if (_descriptor < 0) {
+    return false;
+  }
+
+  struct stat status {};
+  if (fstat(_descriptor, &status) != 0) {
+    close();
+    return false;
+  }
+
+  auto const existing = static_cast<Size>(status.st_size);
+  _chunkOffset = existing / _config.chunkSize * _config.chunkSize;
+  _syncedUpTo = existing;
+  _openedAt = chrono::steady_clock::now();
+  if (!mapChunk()) {
+    close();
+    return false;
+  }
+
+  pbump(static_cast<int>(existing - _chunkOffset));
+  return true;
+#else
+  return false;
+#endif
+}
+
+auto MappedFileBuffer::close() noexcept -> void {
+#if AGE_MAPPED_FILE_AVAILABLE
+  if (_descriptor < 0) {
+    return;
+  }
+
+  auto const size = written();
+  unmapChunk();
+  (void) ftruncate(_descriptor, static_cast<off_t>(size));
+  (void) ::close(_descriptor);
+  _descriptor = -1;
+  _chunkOffset = 0u;
+#endif
+}
+
+auto MappedFileBuffer::mapChunk() noexcept -> bool {
+#if AGE_MAPPED_FILE_AVAILABLE
+  if (ftruncate(_descriptor, static_cast<off_t>(_chunkOffset + _config.chunkSize)) != 0) {
+    return false;
+  }
+
+  auto* pChunk = mmap(nullptr, _config.chunkSize, PROT_READ | PROT_WRITE, MAP_SHARED, _descriptor,
+                      static_cast<off_t>(_chunkOffset));
+  if (pChunk == MAP_FAILED) {
+    return false;
+  }
+
+  auto* pBegin = static_cast<char*>(pChunk);
+  setp(pBegin, pBegin + _config.chunkSize);
+  return true;
+#else
+  return false;
+#endif
+}
+
+auto MappedFileBuffer::unmapChunk() noexcept -> void {
+#if AGE_MAPPED_FILE_AVAILABLE
+  if (pbase() != nullptr) {
+    (void) munmap(pbase(), _config.chunkSize);
+  }
+#endif
+  setp(nullptr, nullptr);
+}
+
+auto MappedFileBuffer::rotate() noexcept -> bool {
+  if (!isOpen()) {
+    return false;
+  }
+
+  close();
+  error_code error;
+  if (_config.backups == 0u) {
+    filesystem::remove(_config.path, error);
+  } else {
+    for (auto index = _config.backups - 1u; index > 0u; --index) {
+      filesystem::rename(backupPath(_config.path, index), backupPath(_config.path, index + 1u), error);
+    }
+    filesystem::rename(_config.path, backupPath(_config.path, 1u), error);
+  }
+
+  if (_pStream != nullptr) {
+    restartBinaryLog(*_pStream);
+  }
+  return open();
+}
+
+auto MappedFileBuffer::overflow(int_type character) -> int_type {
+  if (!isOpen()) {
+    return traits_type::eof();
+  }
+
+  if (pptr() == epptr()) {
+    _chunkOffset += _config.chunkSize;
+    unmapChunk();
+    if (!mapChunk()) {
+      close();
+      return traits_type::eof();
+    }
+  }
+
+  if (!traits_type::eq_int_type(character, traits_type::eof())) {
+    *pptr() = traits_type::to_char_type(character);
+    pbump(1);
+  }
+  return traits_type::not_eof(character);
+}
+
+auto MappedFileBuffer::xsputn(char const* data, std::streamsize count) -> std::streamsize {
+  std::streamsize done = 0;
+  while (done < count) {
+    if (pptr() == epptr() && traits_type::eq_int_type(overflow(traits_type::eof()), traits_type::eof())) {
+      return done;
+    }
+
+    auto const step = std::min(count - done, static_cast<std::streamsize>(epptr() - pptr()));
+    traits_type::copy(pptr(), data + done, static_cast<Size>(step));
+    pbump(static_cast<int>(step));
+    done += step;
+  }
+  return done;
+}
+
+auto MappedFileBuffer::sync() -> int {
+  if (!isOpen()) {
+    return -1;
+  }
+
+  if (rotationDue()) {
+    return rotate() ? 0 : -1;
+  }
+
+#if AGE_MAPPED_FILE_AVAILABLE
+  if (auto const size = written(); size - _syncedUpTo >= _config.syncBytes) {
+    auto const from = std::max(_syncedUpTo, _chunkOffset) / pageSize() * pageSize();
+    (void) msync(pbase() + (from - _chunkOffset), size - from, MS_ASYNC);
+    _syncedUpTo = size;
+  }
+#endif
+  return 0;
+}
+} // namespace meta
+
+MappedFileSink::MappedFileSink(MappedFileConfig config) noexcept : std::ostream(nullptr), _buffer(std::move(config)) {
+  rdbuf(&_buffer);
+  _buffer.attach(*this);
+  if (!_buffer.isOpen()) {
+    setstate(std::ios::badbit);
+  }
+}
+
+auto MappedFileSink::rotate() noexcept -> bool {
+  LoggerOutput const output {*this};
+  auto locked = output.outData();
+  return _buffer.rotate();
+}
+} // namespace age
@@ -0,0 +1,91 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <ostream>
+#include <streambuf>
+
+#include <CDS/meta/TypeTraits>
+
+namespace age {
+struct MappedFileConfig {
+  std::filesystem::path path;
+  /// \brief Size of the region mapped at once. Rounded up to a whole number of pages.
+  cds::Size chunkSize {1u << 20u};
+  /// \brief Rotate once the file reaches this size. 0 disables size-based rotation.
+  cds::Size rotateSize {64u << 20u};
+  /// \brief Rotate once the file has been open this long. 0 disables time-based rotation.
+  std::chrono::seconds rotateInterval {0};
+  /// \brief Number of rotated files kept as path.1 ... path.N, newest first.
+  cds::Size backups {4u};
+  /// \brief Written bytes accumulated before an asynchronous msync is requested.
+  cds::Size syncBytes {256u << 10u};
+};
+
+namespace meta {
+/// \brief Stream buffer appending into a shared memory mapping of a file, one chunk at a time.
+/// sync() runs at record boundaries: it rotates when due and requests an msync once syncBytes were written, but never
+/// waits for the disk, so a flush per record costs no system call.
+class MappedFileBuffer : public std::streambuf {
+public:
+  explicit MappedFileBuffer(MappedFileConfig config) noexcept;
+  MappedFileBuffer(MappedFileBuffer const&) = delete;
+  MappedFileBuffer(MappedFileBuffer&&) = delete;
+  ~MappedFileBuffer() noexcept override;
+
+  auto operator=(MappedFileBuffer const&) = delete;
+  auto operator=(MappedFileBuffer&&) = delete;
+
+  [[nodiscard]] auto isOpen() const noexcept -> bool { return _descriptor >= 0; }
+  auto rotate() noexcept -> bool;
+  /// \brief Stream writing through this buffer. Its binary log state is restarted on rotation, since each file must
+  /// decode on its own.
+  auto attach(std::ostream& stream) noexcept { _pStream = &stream; }
+
+protected:
+  auto overflow(int_type character) -> int_type override;
+  auto xsputn(char const* data, std::streamsize count) -> std::streamsize override;
+  auto sync() -> int override;
+
+private:
+  auto open() noexcept -> bool;
+  auto close() noexcept -> void;
+  auto mapChunk() noexcept -> bool;
+  auto unmapChunk() noexcept -> void;
+  [[nodiscard]] auto written() const noexcept -> cds::Size;
+  [[nodiscard]] auto rotationDue() const noexcept -> bool;
+
+  MappedFileConfig _config;
+  int _descriptor {-1};
+  cds::Size _chunkOffset {0u};
+  cds::Size _syncedUpTo {0u};
+  std::chrono::steady_clock::time_point _openedAt;
+  std::ostream* _pStream {nullptr};
+};
+} // namespace meta
+
+/// \brief Log file written through a memory mapping, with size- and time-based rotation. It is an std::ostream, so it
+/// can be passed wherever a logger accepts one, e.g. Logger::get(name, file, std::cout) or LoggerOutput(file, filter).
+/// Only available on POSIX systems; elsewhere the stream is constructed in a failed state.
+class MappedFileSink : public std::ostream {
+public:
+  explicit MappedFileSink(MappedFileConfig config) noexcept;
+  MappedFileSink(MappedFileSink const&) = delete;
+  MappedFileSink(MappedFileSink&&) = delete;
+  ~MappedFileSink() noexcept override = default;
+
+  auto operator=(MappedFileSink const&) = delete;
+  auto operator=(MappedFileSink&&) = delete;
+
+  [[nodiscard]] auto isOpen() const noexcept { return _buffer.isOpen(); }
+  /// \brief Rotates now, under the lock loggers write this stream under, so it may be called while they log.
+  auto rotate() noexcept -> bool;
+
+private:
+  meta::MappedFileBuffer _buffer;
+};
+} // namespace age
@@ -0,0 +1,36 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include <fstream>
+#include <iostream>
+
+#include <logging/BinaryLogFormat.hpp>
+
+namespace {
+using age::meta::decodeBinaryLog;
+} // namespace
+
+/// Renders binary logs written through LoggerOutput::binary back into the text layout.
+/// Usage: age-logdecode [file...], reading standard input when no file is given.
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    return decodeBinaryLog(std::cin, std::cout) ? 0 : 1;
+  }
+
+  auto status = 0;
+  for (auto index = 1; index < argc; ++index) {
+    std::ifstream in(argv[index], std::ios::binary);
+    if (!in) {
+      std::cerr << "age-logdecode: cannot open " << argv[index] << '\n';
+      status = 1;
+      continue;
+    }
+
+    if (!decodeBinaryLog(in, std::cout)) {
+      std::cerr << "age-logdecode: " << argv[index] << " is not a valid binary log or is truncated\n";
+      status = 1;
+    }
+  }
+  return status;
+}
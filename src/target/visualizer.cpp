@@ -3,10 +3,12 @@
 //
 
 #include <QApplication>
+#include <lang/thread/Dispatcher.hpp>
 #include <settings/SettingsRegistry.hpp>
 #include <window/VisualizerWindow.hpp>
 
 namespace {
+using age::Dispatcher;
 using age::visualizer::VisualizerWindow;
 using age::visualizer::settings::Registry;
 } // namespace
@@ -14,7 +16,14 @@ using age::visualizer::settings::Registry;
 int main(int argc, char** argv) {
   Registry::triggerLoad();
   ::QApplication app(argc, argv);
+  // Tasks resumed on the main thread run from the Qt event loop
+  Dispatcher::mainThread().setWakeup([&app] {
+    ::QMetaObject::invokeMethod(&app, [] { (void) Dispatcher::mainThread().drain(); }, Qt::QueuedConnection);
+  });
+
   VisualizerWindow w;
   w.show();
-  return ::QApplication::exec();
+  auto const status = ::QApplication::exec();
+  Dispatcher::mainThread().setWakeup(nullptr);
+  return status;
 }
@@ -7,10 +7,18 @@
 #include <CDS/threading/Thread>
 #include <atomic>
 #include <condition_variable>
-#include <lang/filesystem/PathAwareFstream.hpp>
+#include <filesystem>
+#include <lang/filesystem/AtomicFileWriter.hpp>
+#include <lang/thread/AsyncBatch.hpp>
+#include <map>
 #include <mutex>
 #include <platform/PathUtils.hpp>
-#include <tuple>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace {
 using namespace cds;
@@ -23,9 +31,10 @@ using std::atomic_flag;
 using std::condition_variable;
 using std::lock_guard;
 using std::mutex;
-using std::tuple;
 using std::unique_lock;
 
+using Changes = std::set<std::string, std::less<>>;
+
 constinit StringView const paddingBuffer = "                                "
                                            "                                "
                                            "                                "
@@ -155,64 +164,128 @@ auto get(auto& json, StringRef key) noexcept(false) -> auto& {
   return current->get(subKey);
 }
 
-auto convertToPath(StringRef key) noexcept -> String {
-  String path = Registry::defaultPath;
-  path += directorySeparator;
-  while (key) {
-    auto dotPos = key.find('.');
-    if (dotPos == StringRef::npos) {
-      dotPos = static_cast<decltype(dotPos)>(key.size());
+/// \brief Group files and subdirectories of one directory of the config tree.
+struct GroupListing {
+  std::vector<String> files;
+  std::vector<String> directories;
+};
+
+struct GroupDirectory {
+  Path path;
+  GroupListing listing;
+  /// \brief Position of the first file of this directory in the parsed files.
+  Size firstFile {0u};
+  /// \brief Position of the first subdirectory of this directory in the tree.
+  Size firstChild {0u};
+};
+
+struct ParsedGroup {
+  enum Failure { None, Malformed, Unreadable };
+
+  JsonObject json;
+  Failure failure {None};
+  std::string error;
+};
+
+auto listGroupDirectory(Path const& path) noexcept -> GroupListing {
+  GroupListing listing;
+  for (auto const& entry : path.walk(1u)) {
+    for (auto const& file : entry.files()) {
+      if (file.endsWith(".json") && (path / file).toString() != Registry::rootFileName) {
+        listing.files.push_back(file);
+      }
     }
 
-    path += StringView(key.takeFront(dotPos));
-    key = key.dropFront(dotPos + 1);
-    if (key) {
-      path += directorySeparator;
+    for (auto const& subdirectory : entry.directories()) {
+      listing.directories.push_back(subdirectory);
     }
   }
-  return path + ".json";
+  return listing;
 }
 
-auto recursiveLoad(Map<String, JsonElement>& map, Path const& path) noexcept -> void {
-  for (auto const& entry : path.walk(1u)) {
-    for (auto const& file : entry.files()) {
-      if (!file.endsWith(".json")) {
-        continue;
-      }
+auto parseGroup(Path const& file) noexcept -> ParsedGroup {
+  ParsedGroup group;
+  try {
+    group.json = loadJson(file);
+  } catch (cds::Exception const& unexpectedError) {
+    std::ostringstream error;
+    error << unexpectedError;
+    group.failure = ParsedGroup::Malformed;
+    group.error = error.str();
+  } catch (std::exception const&) {
+    group.failure = ParsedGroup::Unreadable;
+  }
+  return group;
+}
 
-      if ((path / file).toString() == Registry::rootFileName) {
-        continue;
+/// \brief Lists the config tree level by level, the directories of a level concurrently. Directories are stored in
+/// breadth-first order, the subdirectories of each one contiguous.
+auto discoverGroups(Path const& root) noexcept(false) -> std::vector<GroupDirectory> {
+  std::vector<GroupDirectory> tree;
+  tree.push_back({root, listGroupDirectory(root)});
+
+  AsyncBatch<GroupListing, Path> lister(&listGroupDirectory);
+  for (Size levelBegin = 0u, levelEnd = 1u; levelBegin != levelEnd; levelBegin = std::exchange(levelEnd, tree.size())) {
+    std::vector<Path> nextLevel;
+    for (auto index = levelBegin; index != levelEnd; ++index) {
+      tree[index].firstChild = levelEnd + nextLevel.size();
+      for (auto const& subdirectory : tree[index].listing.directories) {
+        nextLevel.push_back(tree[index].path / subdirectory);
       }
+    }
+
+    lister.trigger(nextLevel);
+    auto listings = lister.await();
+    for (Size index = 0u; index < listings.size(); ++index) {
+      tree.push_back({std::move(nextLevel[index]), std::move(listings[index])});
+    }
+  }
+  return tree;
+}
 
-      StringView key {file.cStr(), file.length() - 5u};
-      try {
-        map.emplace(key, loadJson(path / file));
-      } catch (cds::Exception const& unexpectedError) {
-        std::cerr << "Invalid error while initialising settings group '" << key << "': " << unexpectedError
+/// \brief Moves the parsed groups into the map in the same order a sequential walk would, so that key conflicts
+/// between files and directories resolve the same way on every load.
+auto mergeGroups(Map<String, JsonElement>& map, std::vector<GroupDirectory> const& tree, Size node,
+                 std::vector<ParsedGroup>& parsed) noexcept -> void {
+  auto const& directory = tree[node];
+  for (Size index = 0u; index < directory.listing.files.size(); ++index) {
+    auto const& file = directory.listing.files[index];
+    StringView key {file.cStr(), file.length() - 5u};
+    auto& group = parsed[directory.firstFile + index];
+    try {
+      if (group.failure == ParsedGroup::None) {
+        map.emplace(key, std::move(group.json));
+      } else if (group.failure == ParsedGroup::Malformed) {
+        std::cerr << "Invalid error while initialising settings group '" << key << "': " << group.error
                   << ". Settings will return to default" << std::endl;
-      } catch (std::exception const&) {
+      } else {
         std::cerr << "Failed to open file for settings group '" << key << "'. Settings will return to default"
                   << std::endl;
       }
+    } catch (cds::Exception const& unexpectedError) {
+      std::cerr << "Invalid error while initialising settings group '" << key << "': " << unexpectedError
+                << ". Settings will return to default" << std::endl;
     }
+  }
 
-    for (auto const& directory : entry.directories()) {
-      try {
-        recursiveLoad(map.emplace(directory, JsonObject()).value().getJson(), path / directory);
-      } catch (cds::Exception const& typeException) {
-        std::cerr << "Settings group directory found for key '" << directory
-                  << "', but already in use in primary json by a different data-type: " << typeException
-                  << ". This will not be overwritten." << std::endl;
-      }
+  for (Size index = 0u; index < directory.listing.directories.size(); ++index) {
+    auto const& subdirectory = directory.listing.directories[index];
+    try {
+      mergeGroups(map.emplace(subdirectory, JsonObject()).value().getJson(), tree, directory.firstChild + index,
+                  parsed);
+    } catch (cds::Exception const& typeException) {
+      std::cerr << "Settings group directory found for key '" << subdirectory
+                << "', but already in use in primary json by a different data-type: " << typeException
+                << ". This will not be overwritten." << std::endl;
     }
   }
 }
 
-auto loaderFn(JsonObject* main, JsonObject* copy) noexcept {
+auto loaderFn(JsonObject* main, Snapshot::Pointer* stored) noexcept {
   auto configPath = Path(Registry::defaultPath);
   try {
     *main = loadJson(Registry::rootFileName);
-    recursiveLoad(*main, configPath);
+    Registry::loadGroups(*main, configPath);
   } catch (cds::Exception const& unexpectedError) {
     std::cerr << "Invalid error while initialising settings: " << unexpectedError << ". Settings will return to default"
               << std::endl;
@@ -220,34 +293,195 @@ auto loaderFn(JsonObject* main, JsonObject* copy) noexcept {
     std::cerr << "Root config not found. Settings will return to default" << std::endl;
   }
 
-  *copy = *main;
+  *stored = Snapshot::capture(*main);
 }
 
-auto saveUnderlying(Path const& path, String const& key, JsonObject const& json) -> void {
-  for (auto const& entry : json) {
-    if (entry.value().isJson()) {
-      saveUnderlying(path / key, entry.key(), entry.value().getJson());
+/// \brief Group file to write, and the values to write in it.
+struct GroupFile {
+  std::filesystem::path path;
+  Snapshot::Values values;
+};
+
+/// \brief Collects the files of the groups whose values differ between the snapshot last written and the current one.
+/// Subtrees both snapshots share are skipped without being visited.
+auto changedFiles(Snapshot const* written, Snapshot const& current, std::filesystem::path const& file,
+                  std::filesystem::path const& directory, std::vector<GroupFile>& files) noexcept(false) -> void {
+  if (written == &current) {
+    return;
+  }
+
+  if (written == nullptr || written->sharedValues().get() != current.sharedValues().get()) {
+    files.push_back({file, current.sharedValues()});
+  }
+
+  for (auto const& [name, group] : current.groups()) {
+    changedFiles(written != nullptr ? written->group(name).get() : nullptr, *group, directory / (name + ".json"),
+                 directory / name, files);
+  }
+}
+
+auto writeGroupFile(AtomicFileWriter& writer, GroupFile const& file) noexcept(false) -> void {
+  std::ostringstream contents;
+  filteredDump(contents, *file.values);
+  writer.write(file.path, contents.view());
+}
+
+auto view(StringRef key) noexcept { return std::string_view(key.data(), key.size()); }
+
+auto nested(std::string const& group, StringRef key) noexcept(false) -> std::string {
+  return group.empty() ? std::string(view(key)) : group + '.' + std::string(view(key));
+}
+
+auto isNested(std::string_view key, std::string_view group) noexcept {
+  return key.size() > group.size() && key.starts_with(group) && key[group.size()] == '.';
+}
+
+/// \brief Whether the key, or one of the groups it is nested in, changed as a whole.
+auto changedWhole(Changes const& changes, std::string_view key) noexcept -> bool {
+  if (changes.contains(std::string_view())) {
+    return true;
+  }
+
+  for (auto dotPos = key.find('.');; dotPos = key.find('.', dotPos + 1u)) {
+    if (changes.contains(key.substr(0u, dotPos))) {
+      return true;
     }
+
+    if (dotPos == std::string_view::npos) {
+      return false;
+    }
+  }
+}
+
+/// \brief Changes nested in the group, in key order.
+auto changesIn(Changes const& changes, std::string const& group) noexcept(false) {
+  auto const prefix = group.empty() ? group : group + '.';
+  auto const first = changes.lower_bound(prefix);
+  auto last = first;
+  while (last != changes.end() && last->starts_with(prefix)) {
+    ++last;
   }
+  return std::pair(first, last);
+}
+
+/// \brief Whether one of the entries of the group changed, as opposed to entries of its subgroups only.
+auto changedEntry(Changes const& changes, std::string const& group) noexcept(false) -> bool {
+  auto const [first, last] = changesIn(changes, group);
+  auto const offset = group.empty() ? 0u : group.size() + 1u;
+  return std::any_of(first, last, [offset](auto const& key) { return key.find('.', offset) == std::string::npos; });
+}
 
-  PathAwareOfstream outFile((path / (key + ".json")).toString());
-  filteredDump(outFile, json);
+auto forget(Changes& changes, std::string const& key) noexcept(false) -> void {
+  auto const [first, last] = changesIn(changes, key);
+  changes.erase(first, last);
+  changes.erase(key);
 }
 
-auto saverFn(Path const& path, JsonObject const* json) {
-  for (auto const& entry : *json) {
+/// \brief Snapshot of the group at the key, sharing with the previous snapshot every subgroup no change is nested in.
+auto update(Snapshot::Pointer const& previous, JsonObject const& group, Changes const& changes, std::string const& key)
+    noexcept(false) -> Snapshot::Pointer {
+  if (previous.get() == nullptr || changedWhole(changes, key)) {
+    return Snapshot::capture(group);
+  }
+
+  if (auto const [first, last] = changesIn(changes, key); first == last) {
+    return previous;
+  }
+
+  Snapshot::Groups groups;
+  for (auto const& entry : group) {
     if (entry.value().isJson()) {
-      saveUnderlying(path.parent(), entry.key(), entry.value().getJson());
+      groups.emplace(std::string(view(entry.key())),
+                     update(previous->group(entry.key()), entry.value().getJson(), changes, nested(key, entry.key())));
     }
   }
+  return cds::makeShared<Snapshot>(changedEntry(changes, key) ? Snapshot::valuesOf(group) : previous->sharedValues(),
+                                   std::move(groups));
+}
 
-  PathAwareOfstream outFile(path.toString());
-  filteredDump(outFile, *json);
+/// \brief Copy of the snapshot of the group at the path, with the element at the key taken from the group and the
+/// groups leading to it added where missing. Everything else is shared with the previous snapshot.
+auto assign(Snapshot::Pointer const& previous, JsonObject const& group, StringRef key, Changes const& changes,
+            std::string const& path) noexcept(false) -> Snapshot::Pointer {
+  auto const name = sub(key);
+  auto const& element = group.get(name);
+  auto const assignsValue = !key && !element.isJson();
+
+  Snapshot::Groups groups;
+  Snapshot::Pointer previousGroup;
+  auto values = previous.get() != nullptr ? previous->sharedValues() : cds::makeShared<JsonObject>();
+  if (previous.get() != nullptr) {
+    groups = previous->groups();
+    previousGroup = previous->group(name);
+  }
+
+  // The values are copied only if the entry is one of them, or replaces one of them
+  if (assignsValue || values->find(name) != values->end()) {
+    auto const previousValues = std::move(values);
+    values = cds::makeShared<JsonObject>();
+    bool replaced = false;
+    for (auto const& entry : *previousValues) {
+      if (view(entry.key()) != view(name)) {
+        values->emplace(entry.key(), entry.value());
+      } else if (assignsValue) {
+        values->emplace(entry.key(), element);
+        replaced = true;
+      }
+    }
+
+    if (assignsValue && !replaced) {
+      values->emplace(StringView(name), element);
+    }
+  }
+
+  auto const groupName = std::string(view(name));
+  if (assignsValue) {
+    groups.erase(groupName);
+  } else if (key) {
+    groups.insert_or_assign(groupName, assign(previousGroup, element.getJson(), key, changes, nested(path, name)));
+  } else {
+    groups.insert_or_assign(groupName, update(previousGroup, element.getJson(), changes, nested(path, name)));
+  }
+  return cds::makeShared<Snapshot>(std::move(values), std::move(groups));
+}
+
+auto restoreEntry(JsonObject& group, StringRef key, auto&& value) noexcept(false) -> void {
+  if (auto it = group.find(key); it != group.end()) {
+    it->value() = std::forward<decltype(value)>(value);
+  } else {
+    group.emplace(StringView(key), std::forward<decltype(value)>(value));
+  }
+}
+
+auto dropEntries(JsonObject& group, std::set<std::string, std::less<>> const& keys) noexcept(false) -> void {
+  JsonObject kept;
+  for (auto& entry : group) {
+    if (!keys.contains(view(entry.key()))) {
+      kept.emplace(entry.key(), std::move(entry.value()));
+    }
+  }
+  group = std::move(kept);
 }
 } // namespace
 
 auto Registry::sub(StringRef& key) noexcept -> StringRef { return ::sub(key); }
 
+auto Registry::loadGroups(JsonObject& json, Path const& directory) noexcept(false) -> void {
+  auto tree = discoverGroups(directory);
+  std::vector<Path> files;
+  for (auto& node : tree) {
+    node.firstFile = files.size();
+    for (auto const& file : node.listing.files) {
+      files.push_back(node.path / file);
+    }
+  }
+
+  AsyncBatch<ParsedGroup, Path> parser(&parseGroup);
+  parser.trigger(files);
+  auto parsed = parser.await();
+  mergeGroups(json, tree, 0u, parsed);
+}
+
 auto Registry::active() noexcept(false) -> Registry& {
   if (!_registry) {
     _registry = cds::makeUnique<Registry>(Token {});
@@ -255,6 +489,7 @@ auto Registry::active() noexcept(false) -> Registry& {
 
   if (!_registry->_loaded) {
     _registry->_loader->await();
+    _registry->_written = _registry->_stored;
     _registry->_loaded = true;
   }
 
@@ -262,28 +497,89 @@ auto Registry::active() noexcept(false) -> Registry& {
 }
 
 Registry::Registry([[maybe_unused]] Token) noexcept :
-    _loader(cds::makeUnique<AsyncRunner<void, JsonObject*, JsonObject*>>(loaderFn)),
-    _saver(cds::makeUnique<AsyncRunner<void, Path, JsonObject const*>>(saverFn)) {
+    _loader(cds::makeUnique<AsyncRunner<void, JsonObject*, Snapshot::Pointer*>>(loaderFn)),
+    _saver(cds::makeUnique<AsyncRunner<void>>([this] { writePending(); })) {
   _loader->trigger(&_active, &_stored);
 }
 
 auto Registry::reset(StringRef key) noexcept(false) -> void {
-  auto* lJson = &_active;
-  auto* rJson = &_stored;
-
+  ++_generation;
+  _groupLent = false;
   if (!key) {
-    *lJson = *rJson;
+    restoreChanges();
     return;
   }
 
+  auto const changed = std::string(view(key));
+  auto* lJson = &_active;
+  auto const* rGroup = _stored.get();
   auto subKey = sub(key);
   while (key) {
     lJson = &lJson->getJson(subKey);
-    rJson = &rJson->getJson(subKey);
+    rGroup = &rGroup->getGroup(subKey);
     subKey = sub(key);
   }
 
-  lJson->get(subKey) = rJson->get(subKey);
+  if (auto const group = rGroup->group(subKey); group.get() != nullptr) {
+    lJson->get(subKey) = group->materialize();
+  } else {
+    lJson->get(subKey) = rGroup->values().get(subKey);
+  }
+  forget(_changes, changed);
+}
+
+auto Registry::restoreChanges() noexcept(false) -> void {
+  if (_changes.contains(std::string_view())) {
+    _active = _stored->materialize();
+    _changes.clear();
+    return;
+  }
+
+  // Keys missing from the snapshot are dropped from their groups afterwards, innermost groups first, since dropping
+  // rebuilds the group
+  std::map<std::string, std::set<std::string, std::less<>>, std::greater<>> dropped;
+  std::string_view restored;
+  for (auto const& changed : _changes) {
+    if (!restored.empty() && isNested(changed, restored)) {
+      continue;
+    }
+
+    restored = changed;
+    StringRef key = changed;
+    auto* lJson = &_active;
+    auto const* rGroup = _stored.get();
+    auto subKey = sub(key);
+    while (key) {
+      lJson = &lJson->getJson(subKey);
+      rGroup = rGroup != nullptr ? rGroup->group(subKey).get() : nullptr;
+      subKey = sub(key);
+    }
+
+    auto const group = rGroup != nullptr ? rGroup->group(subKey) : Snapshot::Pointer();
+    if (group.get() != nullptr) {
+      restoreEntry(*lJson, subKey, group->materialize());
+      continue;
+    }
+
+    if (rGroup != nullptr) {
+      if (auto const it = rGroup->values().find(subKey); it != rGroup->values().end()) {
+        restoreEntry(*lJson, subKey, it->value());
+        continue;
+      }
+    }
+
+    auto const offset = static_cast<std::size_t>(subKey.data() - changed.data());
+    dropped[changed.substr(0u, offset == 0u ? 0u : offset - 1u)].emplace(view(subKey));
+  }
+
+  for (auto const& [group, keys] : dropped) {
+    auto* lJson = &_active;
+    for (StringRef key = group; key;) {
+      lJson = &lJson->getJson(sub(key));
+    }
+    dropEntries(*lJson, keys);
+  }
+  _changes.clear();
 }
 
 auto Registry::replaceIfMissing(JsonObject* pJson, StringRef key, bool overwriteType) noexcept -> void {
@@ -294,33 +590,102 @@ auto Registry::replaceIfMissing(JsonObject* pJson, StringRef key, bool overwrite
   }
 }
 
-auto Registry::save(StringRef key) noexcept(false) -> void {
-  _saver->await();
-  auto lJson = &_stored;
-  auto rJson = &_active;
-  String savePath = key ? convertToPath(key) : rootFileName;
+auto Registry::touch(StringRef key) noexcept(false) -> void {
+  auto const changed = key;
+  auto* current = &_active;
+  auto subKey = sub(key);
+  while (key) {
+    auto it = current->find(subKey);
+    if (it == current->end() || !it->value().isJson()) {
+      break;
+    }
 
-  if (key) {
-    auto subKey = sub(key);
-    while (key) {
-      replaceIfMissing(lJson, subKey, true);
+    current = &it->value().getJson();
+    subKey = sub(key);
+  }
 
-      lJson = &lJson->getJson(subKey);
-      rJson = &rJson->getJson(subKey);
-      subKey = sub(key);
-    }
-    replaceIfMissing(lJson, subKey);
-    auto& lSub = lJson->get(subKey);
-    auto const& rSub = rJson->get(subKey);
-    lSub = rSub;
-    if (lSub.isJson()) {
-      lJson = &lSub.getJson();
+  // Adding entries, or overwriting groups, may move or destroy the elements cached by keys
+  if (auto const it = current->find(subKey); key || it == current->end() || it->value().isJson()) {
+    ++_generation;
+  }
+  _changes.emplace(changed.data(), static_cast<std::size_t>(subKey.data() + subKey.size() - changed.data()));
+}
+
+auto Registry::resolve(Key const& key) const noexcept(false) -> JsonElement const& {
+  if (_groupLent || key._generation != _generation) {
+    auto const* current = &_active;
+    for (Size index = 0u; index + 1u < key.depth(); ++index) {
+      current = &current->getJson(StringRef(key.segment(index)));
     }
+
+    // No generation is zero, so an element resolved while a group is lent is never reused
+    key._element = &current->get(StringRef(key.segment(key.depth() - 1u)));
+    key._generation = _groupLent ? 0u : _generation;
+  }
+  return *key._element;
+}
+
+auto Registry::save(StringRef key) noexcept(false) -> void {
+  _groupLent = false;
+  if (key) {
+    _stored = assign(_stored, _active, key, _changes, "");
+    forget(_changes, std::string(view(key)));
   } else {
-    *lJson = *rJson;
+    _stored = update(_stored, _active, _changes, "");
+    _changes.clear();
   }
 
-  _saver->trigger(savePath, lJson);
+  // A saver already running writes the new snapshot once done, so saves made meanwhile share one pass
+  bool idle = false;
+  {
+    lock_guard const lock(_saveLock);
+    _pending = _stored;
+    idle = !std::exchange(_saving, true);
+  }
+
+  if (idle) {
+    _saver->trigger();
+  }
+}
+
+auto Registry::writePending() noexcept -> void {
+  while (true) {
+    Snapshot::Pointer target;
+    {
+      lock_guard const lock(_saveLock);
+      if (_pending.get() == nullptr) {
+        _saving = false;
+        return;
+      }
+      target = std::exchange(_pending, Snapshot::Pointer());
+    }
+
+    try {
+      std::vector<GroupFile> files;
+      changedFiles(_written.get(), *target, rootFileName, defaultPath, files);
+
+      std::set<std::filesystem::path> directories;
+      for (auto const& file : files) {
+        directories.insert(file.path.parent_path());
+      }
+
+      for (auto const& directory : directories) {
+        std::filesystem::create_directories(directory);
+      }
+
+      // Each file is replaced atomically, and the renames made durable with one sync per directory
+      AtomicFileWriter fileWriter;
+      AsyncBatch<void, GroupFile> writer([&fileWriter](GroupFile const& file) { writeGroupFile(fileWriter, file); });
+      writer.trigger(files);
+      writer.await();
+      fileWriter.commit();
+      _written = std::move(target);
+    } catch (std::exception const& error) {
+      // The files are compared against the snapshot written last, so the next save writes these again
+      std::cerr << "Failed to save settings: " << error.what() << ". Changes will be saved again on the next save"
+                << std::endl;
+    }
+  }
 }
 
 auto Registry::getInt(StringRef key) const noexcept(false) -> int { return get(_active, key).getInt(); }
@@ -329,14 +694,38 @@ auto Registry::getFloat(StringRef key) const noexcept(false) -> float { return g
 auto Registry::getDouble(StringRef key) const noexcept(false) -> double { return get(_active, key).getDouble(); }
 auto Registry::getString(StringRef key) const noexcept(false) -> String const& { return get(_active, key).getString(); }
 auto Registry::getJson(StringRef key) const noexcept(false) -> JsonObject const& { return get(_active, key).getJson(); }
-auto Registry::getString(StringRef key) noexcept(false) -> String& { return get(_active, key).getString(); }
-auto Registry::getArray(StringRef key) noexcept(false) -> JsonArray& { return get(_active, key).getArray(); }
-auto Registry::getJson(StringRef key) noexcept(false) -> JsonObject& { return get(_active, key).getJson(); }
+
+auto Registry::getString(StringRef key) noexcept(false) -> String& {
+  auto& value = get(_active, key).getString();
+  touch(key);
+  return value;
+}
+
+auto Registry::getArray(StringRef key) noexcept(false) -> JsonArray& {
+  auto& value = get(_active, key).getArray();
+  touch(key);
+  return value;
+}
+
+auto Registry::getJson(StringRef key) noexcept(false) -> JsonObject& {
+  auto& value = get(_active, key).getJson();
+  touch(key);
+  _groupLent = true;
+  return value;
+}
 
 auto Registry::getArray(StringRef key) const noexcept(false) -> JsonArray const& {
   return get(_active, key).getArray();
 }
 
+auto Registry::getInt(Key const& key) const noexcept(false) -> int { return resolve(key).getInt(); }
+auto Registry::getLong(Key const& key) const noexcept(false) -> long { return resolve(key).getLong(); }
+auto Registry::getFloat(Key const& key) const noexcept(false) -> float { return resolve(key).getFloat(); }
+auto Registry::getDouble(Key const& key) const noexcept(false) -> double { return resolve(key).getDouble(); }
+auto Registry::getString(Key const& key) const noexcept(false) -> String const& { return resolve(key).getString(); }
+auto Registry::getArray(Key const& key) const noexcept(false) -> JsonArray const& { return resolve(key).getArray(); }
+auto Registry::getJson(Key const& key) const noexcept(false) -> JsonObject const& { return resolve(key).getJson(); }
+
 Registry::~Registry() noexcept {
   _saver->await();
   _loader->await();
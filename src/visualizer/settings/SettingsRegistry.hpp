@@ -7,8 +7,16 @@
 #include <CDS/memory/UniquePointer>
 #include <CDS/util/JSON>
 
+#include <array>
+#include <functional>
 #include <lang/string/StringRef.hpp>
 #include <lang/thread/AsyncRunner.hpp>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <settings/SettingsSnapshot.hpp>
 
 namespace age::visualizer::settings {
 class Registry {
@@ -26,6 +34,46 @@ private:
   };
 
 public:
+  /// \brief Dotted key split into its segments once, at compile time when built from a literal. Getters taking a Key
+  /// cache the element it resolves to, and resolve it again only after a structural change to the settings, so reading
+  /// a setting every frame costs no lookups. Caching stops while a group returned by the mutable getJson may still be
+  /// modified, until the next put, replace, reset or save. Keys are meant to be static, e.g.
+  /// static constinit Registry::Key const width {"window.width"}. A Key does not own its string, and caches for one
+  /// thread at a time.
+  class Key {
+  public:
+    static constexpr cds::Size const maxDepth = 16u;
+
+    constexpr explicit Key(std::string_view key) noexcept(false) : _key(key) {
+      for (cds::Size position = 0u; position <= key.size(); ++position) {
+        if (position != key.size() && key[position] != '.') {
+          continue;
+        }
+
+        if (_depth == maxDepth) {
+          throw std::length_error("Settings key nested too deep");
+        }
+        _ends[_depth++] = position;
+      }
+    }
+
+    [[nodiscard]] constexpr auto depth() const noexcept { return _depth; }
+    [[nodiscard]] constexpr auto string() const noexcept { return _key; }
+    [[nodiscard]] constexpr auto segment(cds::Size index) const noexcept -> std::string_view {
+      auto const begin = index == 0u ? 0u : _ends[index - 1u] + 1u;
+      return _key.substr(begin, _ends[index] - begin);
+    }
+
+  private:
+    friend class Registry;
+
+    std::string_view _key;
+    std::array<cds::Size, maxDepth> _ends {};
+    cds::Size _depth {0u};
+    mutable cds::json::JsonElement const* _element {nullptr};
+    mutable cds::uint64 _generation {0u};
+  };
+
   [[nodiscard]] auto getInt(StringRef key) const noexcept(false) -> int;
   [[nodiscard]] auto getLong(StringRef key) const noexcept(false) -> long;
   [[nodiscard]] auto getFloat(StringRef key) const noexcept(false) -> float;
@@ -37,12 +85,24 @@ public:
   [[nodiscard]] auto getArray(StringRef key) noexcept(false) -> cds::json::JsonArray&;
   [[nodiscard]] auto getJson(StringRef key) noexcept(false) -> cds::json::JsonObject&;
 
+  [[nodiscard]] auto getInt(Key const& key) const noexcept(false) -> int;
+  [[nodiscard]] auto getLong(Key const& key) const noexcept(false) -> long;
+  [[nodiscard]] auto getFloat(Key const& key) const noexcept(false) -> float;
+  [[nodiscard]] auto getDouble(Key const& key) const noexcept(false) -> double;
+  [[nodiscard]] auto getString(Key const& key) const noexcept(false) -> cds::String const&;
+  [[nodiscard]] auto getArray(Key const& key) const noexcept(false) -> cds::json::JsonArray const&;
+  [[nodiscard]] auto getJson(Key const& key) const noexcept(false) -> cds::json::JsonObject const&;
+
   template <typename Type> auto put(StringRef key, Type&& value) noexcept(false) -> Registry&;
   template <typename Type> auto replace(StringRef key, Type&& value) noexcept(false) -> Registry&;
 
   explicit(false) Registry(Token) noexcept;
   ~Registry() noexcept;
 
+  /// \brief Loads every group file under the directory into the json, a group directory becoming a nested object.
+  /// Files are discovered and parsed concurrently, then merged in directory order.
+  static auto loadGroups(cds::json::JsonObject& json, cds::filesystem::Path const& directory) noexcept(false) -> void;
+
   static constexpr auto const defaultPath = "./config";
   static constexpr auto const rootFileName = "./config/registryBase.json";
 
@@ -51,11 +111,37 @@ private:
   static auto replaceIfMissing(cds::json::JsonObject* pJson, StringRef key, bool overwriteType = false) noexcept
       -> void;
 
+  /// \brief Records that the value at the key may change. Keys whose parent groups are about to be created or
+  /// overwritten record the outermost such group instead. Unless the key names an existing value, the change may be
+  /// structural, and invalidates the elements cached by keys.
+  auto touch(StringRef key) noexcept(false) -> void;
+  /// \brief The element at the key, from its cache if no structural change happened since it was resolved.
+  [[nodiscard]] auto resolve(Key const& key) const noexcept(false) -> cds::json::JsonElement const&;
+  /// \brief Restores every changed key from _stored, dropping the keys it does not hold.
+  auto restoreChanges() noexcept(false) -> void;
+  /// \brief Writes the files of the groups changed by the snapshots saved since the last write, the latest snapshot
+  /// only, until no save is pending.
+  auto writePending() noexcept -> void;
+
   bool _loaded = false;
+  /// \brief Incremented on structural changes to _active, invalidating the elements cached by keys.
+  cds::uint64 _generation {1u};
+  /// \brief Set while a group returned by the mutable getJson may be restructured without the registry knowing. Keys
+  /// resolve without caching until the next put, replace, reset or save.
+  bool _groupLent = false;
   cds::json::JsonObject _active;
-  cds::json::JsonObject _stored;
-  cds::UniquePointer<AsyncRunner<void, cds::json::JsonObject*, cds::json::JsonObject*>> const _loader;
-  cds::UniquePointer<AsyncRunner<void, cds::filesystem::Path, cds::json::JsonObject const*>> const _saver;
+  /// \brief Settings as last loaded or saved. Saves replace it with a snapshot sharing every unchanged group.
+  Snapshot::Pointer _stored;
+  /// \brief Dotted keys that may differ between _active and _stored, each covering everything nested under it.
+  std::set<std::string, std::less<>> _changes;
+  cds::UniquePointer<AsyncRunner<void, cds::json::JsonObject*, Snapshot::Pointer*>> const _loader;
+  std::mutex _saveLock;
+  /// \brief Latest snapshot saved but not written yet. Guarded by _saveLock, as is _saving.
+  Snapshot::Pointer _pending;
+  bool _saving = false;
+  /// \brief Snapshot the config files match. Used by the saver only, once loaded.
+  Snapshot::Pointer _written;
+  cds::UniquePointer<AsyncRunner<void>> const _saver;
   static constexpr cds::StringView const pathInternalPrefix = "__resourcepath__";
   static inline cds::UniquePointer<Registry> _registry = nullptr;
 };
@@ -63,6 +149,8 @@ private:
 inline auto registry() noexcept(false) -> Registry& { return Registry::active(); }
 
 template <typename Type> auto Registry::put(StringRef key, Type&& value) noexcept(false) -> Registry& {
+  touch(key);
+  _groupLent = false;
   auto current = &_active;
   auto subKey = sub(key);
   while (key) {
@@ -75,6 +163,8 @@ template <typename Type> auto Registry::put(StringRef key, Type&& value) noexcep
 }
 
 template <typename Type> auto Registry::replace(StringRef key, Type&& value) noexcept(false) -> Registry& {
+  touch(key);
+  _groupLent = false;
   auto current = &_active;
   auto subKey = sub(key);
   while (key) {
@@ -0,0 +1,63 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include "SettingsSnapshot.hpp"
+#include <string_view>
+#include <utility>
+
+namespace {
+using namespace cds::json;
+using namespace age;
+using namespace age::visualizer::settings;
+
+auto view(StringRef name) noexcept { return std::string_view(name.data(), name.size()); }
+} // namespace
+
+Snapshot::Snapshot(Values values, Groups groups) noexcept :
+    _values(std::move(values)), _groups(std::move(groups)) {}
+
+auto Snapshot::capture(JsonObject const& group) noexcept(false) -> Pointer {
+  Groups groups;
+  for (auto const& entry : group) {
+    if (entry.value().isJson()) {
+      groups.emplace(std::string(entry.key().cStr(), entry.key().length()), capture(entry.value().getJson()));
+    }
+  }
+  return cds::makeShared<Snapshot>(valuesOf(group), std::move(groups));
+}
+
+auto Snapshot::valuesOf(JsonObject const& group) noexcept(false) -> Values {
+  auto values = cds::makeShared<JsonObject>();
+  for (auto const& entry : group) {
+    if (!entry.value().isJson()) {
+      values->emplace(entry.key(), entry.value());
+    }
+  }
+  return values;
+}
+
+auto Snapshot::materialize() const noexcept(false) -> JsonObject {
+  auto group = *_values;
+  for (auto const& [name, snapshot] : _groups) {
+    group.emplace(name.c_str(), snapshot->materialize());
+  }
+  return group;
+}
+
+auto Snapshot::group(StringRef name) const noexcept -> Pointer {
+  if (auto it = _groups.find(view(name)); it != _groups.end()) {
+    return it->second;
+  }
+  return {};
+}
+
+auto Snapshot::getGroup(StringRef name) const noexcept(false) -> Snapshot const& {
+  if (auto it = _groups.find(view(name)); it != _groups.end()) {
+    return *it->second;
+  }
+
+  // Values never hold groups, so the lookup fails either on the key or on its type, as it would in a JsonObject
+  (void) _values->getJson(name);
+  return *_groups.at(std::string(view(name)));
+}
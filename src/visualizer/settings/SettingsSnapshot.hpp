@@ -0,0 +1,50 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#pragma once
+#include <CDS/memory/SharedPointer>
+#include <CDS/util/JSON>
+
+#include <functional>
+#include <lang/string/StringRef.hpp>
+#include <map>
+#include <string>
+
+namespace age::visualizer::settings {
+/// \brief Immutable copy of a settings group: its values, and a snapshot of each of its subgroups. Snapshots are
+/// never modified once built, so a new snapshot differing from a previous one in a few groups shares every other
+/// subgroup with it, and can be handed to another thread without copying. Groups whose values did not change share
+/// those too, so comparing two snapshots of the same tree tells which group files changed.
+class Snapshot {
+public:
+  using Pointer = cds::SharedPointer<Snapshot>;
+  using Values = cds::SharedPointer<cds::json::JsonObject>;
+  using Groups = std::map<std::string, Pointer, std::less<>>;
+
+  Snapshot(Values values, Groups groups) noexcept;
+
+  /// \brief Snapshot of the group and of every group nested in it.
+  static auto capture(cds::json::JsonObject const& group) noexcept(false) -> Pointer;
+
+  /// \brief Entries of the group that are not groups themselves.
+  static auto valuesOf(cds::json::JsonObject const& group) noexcept(false) -> Values;
+
+  /// \brief The group rebuilt as a json object, subgroups included.
+  [[nodiscard]] auto materialize() const noexcept(false) -> cds::json::JsonObject;
+
+  /// \brief The direct subgroup, or an empty pointer if there is none.
+  [[nodiscard]] auto group(StringRef name) const noexcept -> Pointer;
+
+  /// \brief The direct subgroup. Throws what JsonObject::getJson would if there is none.
+  [[nodiscard]] auto getGroup(StringRef name) const noexcept(false) -> Snapshot const&;
+
+  [[nodiscard]] auto values() const noexcept -> cds::json::JsonObject const& { return *_values; }
+  [[nodiscard]] auto sharedValues() const noexcept -> Values const& { return _values; }
+  [[nodiscard]] auto groups() const noexcept -> Groups const& { return _groups; }
+
+private:
+  Values _values;
+  Groups _groups;
+};
+} // namespace age::visualizer::settings
@@ -0,0 +1,67 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include <core/lang/thread/AsyncRunner.hpp>
+#include <core/lang/thread/Executor.hpp>
+
+namespace {
+using age::AsyncRunner;
+using age::Executor;
+using std::chrono::steady_clock;
+
+auto percentile(std::vector<steady_clock::duration::rep>& samples, double rank) {
+  if (samples.empty()) {
+    return 0.0;
+  }
+
+  std::sort(samples.begin(), samples.end());
+  return static_cast<double>(samples[static_cast<std::size_t>(rank * static_cast<double>(samples.size() - 1u))]);
+}
+
+auto report(benchmark::State& state, char const* name, std::vector<steady_clock::duration::rep>& samples) {
+  state.counters[std::string(name) + "_p50_ns"] = percentile(samples, 0.5);
+  state.counters[std::string(name) + "_p99_ns"] = percentile(samples, 0.99);
+}
+
+/// \brief Latency from trigger to the function starting on a worker, and from the function returning to await
+/// returning, on an executor with one idle worker.
+auto triggerAwaitLatency(benchmark::State& state) {
+  using std::chrono::duration_cast;
+  using std::chrono::nanoseconds;
+
+  Executor executor(1u);
+  steady_clock::time_point startedAt;
+  AsyncRunner<steady_clock::time_point> runner(
+      [&startedAt] {
+        startedAt = steady_clock::now();
+        return steady_clock::now();
+      },
+      executor);
+
+  std::vector<steady_clock::duration::rep> toStart;
+  std::vector<steady_clock::duration::rep> toAwait;
+  toStart.reserve(1u << 20u);
+  toAwait.reserve(1u << 20u);
+  for (auto _ : state) {
+    auto const triggeredAt = steady_clock::now();
+    runner.trigger();
+    auto const endedAt = runner.await();
+    auto const awaitedAt = steady_clock::now();
+    toStart.push_back(duration_cast<nanoseconds>(startedAt - triggeredAt).count());
+    toAwait.push_back(duration_cast<nanoseconds>(awaitedAt - endedAt).count());
+  }
+
+  report(state, "start", toStart);
+  report(state, "await", toAwait);
+  state.SetItemsProcessed(state.iterations());
+}
+} // namespace
+
+BENCHMARK(triggerAwaitLatency)->UseRealTime();
@@ -0,0 +1,145 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <core/logging/Logger.hpp>
+
+namespace {
+using age::Logger;
+
+/// \brief Accepts and discards everything, so only the logger itself is measured.
+class NullBuffer : public std::streambuf {
+protected:
+  auto overflow(int_type character) -> int_type override { return traits_type::not_eof(character); }
+  auto xsputn(char const* data, std::streamsize count) -> std::streamsize override {
+    (void) data;
+    return count;
+  }
+};
+
+enum Sink : long { Null, File };
+
+struct Sinks {
+  Sinks() {
+    for (auto index = 0u; index < 2u; ++index) {
+      files[index].open(std::filesystem::temp_directory_path() / ("age_logger_benchmark" + std::to_string(index)));
+    }
+  }
+
+  NullBuffer nullBuffers[2];
+  std::ostream nulls[2] {std::ostream(&nullBuffers[0]), std::ostream(&nullBuffers[1])};
+  std::ofstream files[2];
+};
+
+auto sinks() -> Sinks& {
+  static Sinks sinks;
+  return sinks;
+}
+
+using Options = age::meta::LogOptionFlags;
+
+constexpr Options const optionSets[] = {
+    0u,
+    static_cast<Options>(Logger::OptionFlag::SourceLocation),
+    static_cast<Options>(Logger::OptionFlag::Timestamp),
+    static_cast<Options>(Logger::OptionFlag::ThreadId),
+    Logger::OptionFlag::SourceLocation | Logger::OptionFlag::Timestamp | Logger::OptionFlag::ThreadId,
+};
+
+constexpr char const* const optionNames[] = {"none", "location", "timestamp", "thread", "location+timestamp+thread"};
+
+/// \brief Arguments: option set index, Sink, number of outputs (1 or 2).
+auto makeLogger(benchmark::State const& state) {
+  auto& out = sinks();
+  auto const sink = static_cast<Sink>(state.range(1));
+  auto& first = sink == Null ? out.nulls[0] : static_cast<std::ostream&>(out.files[0]);
+  auto& second = sink == Null ? out.nulls[1] : static_cast<std::ostream&>(out.files[1]);
+  auto logger = state.range(2) == 1 ? Logger::get(first) : Logger::get(first, second);
+
+  logger.setOptions(optionSets[state.range(0)]);
+  return logger;
+}
+
+auto label(benchmark::State& state) {
+  state.SetLabel(std::string(optionNames[state.range(0)]) + (state.range(1) == Null ? ", null" : ", file") + ", "
+                 + std::to_string(state.range(2)) + " output(s)");
+}
+
+/// \brief Builds defining NDEBUG compile logging out, which would leave only an inactive writer to measure.
+auto loggingCompiledIn(benchmark::State& state) {
+  if (!age::meta::LoggingEnabled::value) {
+    state.SkipWithError("logging is compiled out, configure without NDEBUG as described in docs/Testing.adoc");
+  }
+  return age::meta::LoggingEnabled::value;
+}
+
+auto throughput(benchmark::State& state) {
+  if (!loggingCompiledIn(state)) {
+    return;
+  }
+
+  auto logger = makeLogger(state);
+  long index = 0;
+  for (auto _ : state) {
+    logger() << "record " << ++index << " of the throughput benchmark";
+  }
+  state.SetItemsProcessed(state.iterations());
+  label(state);
+}
+
+auto latency(benchmark::State& state) {
+  using namespace std::chrono;
+  if (!loggingCompiledIn(state)) {
+    return;
+  }
+
+  auto logger = makeLogger(state);
+  std::vector<nanoseconds::rep> samples;
+  samples.reserve(1u << 20u);
+  long index = 0;
+  for (auto _ : state) {
+    auto const start = steady_clock::now();
+    logger() << "record " << ++index << " of the latency benchmark";
+    samples.push_back(duration_cast<nanoseconds>(steady_clock::now() - start).count());
+  }
+
+  std::sort(samples.begin(), samples.end());
+  auto const percentile = [&samples](double rank) {
+    if (samples.empty()) {
+      return 0.0;
+    }
+    return static_cast<double>(samples[static_cast<std::size_t>(rank * static_cast<double>(samples.size() - 1u))]);
+  };
+
+  // Per-record latencies, including the cost of reading the clock twice, averaged over the threads
+  state.counters["p50_ns"] = benchmark::Counter(percentile(0.5), benchmark::Counter::kAvgThreads);
+  state.counters["p99_ns"] = benchmark::Counter(percentile(0.99), benchmark::Counter::kAvgThreads);
+  state.counters["p999_ns"] = benchmark::Counter(percentile(0.999), benchmark::Counter::kAvgThreads);
+  state.SetItemsProcessed(state.iterations());
+  label(state);
+}
+
+auto configurations(benchmark::internal::Benchmark* pBenchmark) {
+  for (long options = 0; options < static_cast<long>(std::size(optionSets)); ++options) {
+    for (auto sink : {Null, File}) {
+      for (long outputs : {1, 2}) {
+        pBenchmark->Args({options, sink, outputs});
+      }
+    }
+  }
+  pBenchmark->ThreadRange(1, 8)->UseRealTime();
+}
+} // namespace
+
+BENCHMARK(throughput)->Apply(configurations);
+BENCHMARK(latency)->Apply(configurations);
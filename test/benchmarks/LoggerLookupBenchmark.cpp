@@ -0,0 +1,57 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <string>
+
+#include <core/logging/Logger.hpp>
+
+namespace {
+using age::Logger;
+
+auto const loggerNames = [] {
+  std::array<std::string, 64u> names;
+  for (auto index = 0u; index < names.size(); ++index) {
+    names[index] = "benchmark" + std::to_string(index);
+  }
+  return names;
+}();
+
+/// \brief Named loggers are only kept in builds with logging compiled in, i.e. without NDEBUG.
+auto namedLoggersKept(benchmark::State& state) {
+  if (!age::meta::LoggingEnabled::value) {
+    state.SkipWithError("logging is compiled out, configure without NDEBUG as described in docs/Testing.adoc");
+  }
+  return age::meta::LoggingEnabled::value;
+}
+
+auto lookupSameName(benchmark::State& state) {
+  if (!namedLoggersKept(state)) {
+    return;
+  }
+
+  (void) Logger::get("benchmark");
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(&Logger::get("benchmark"));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+auto lookupManyNames(benchmark::State& state) {
+  if (!namedLoggersKept(state)) {
+    return;
+  }
+
+  auto index = static_cast<std::size_t>(state.thread_index());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(&Logger::get(loggerNames[index++ % loggerNames.size()]));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+} // namespace
+
+BENCHMARK(lookupSameName)->ThreadRange(1, 32)->UseRealTime();
+BENCHMARK(lookupManyNames)->ThreadRange(1, 32)->UseRealTime();
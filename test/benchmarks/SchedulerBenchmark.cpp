@@ -0,0 +1,108 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <core/lang/thread/Scheduler.hpp>
+
+namespace {
+using age::Scheduler;
+using age::TaskGroup;
+
+/// \brief Below it, fib recurses serially, so a task does enough work to amortize spawning it.
+constexpr auto const fibCutoff = 16;
+/// \brief Below it, quicksort sorts serially.
+constexpr auto const sortCutoff = std::ptrdiff_t {2048};
+
+auto serialFib(int n) -> long { return n < 2 ? n : serialFib(n - 1) + serialFib(n - 2); }
+
+auto parallelFib(Scheduler& scheduler, int n) -> long {
+  if (n < fibCutoff) {
+    return serialFib(n);
+  }
+
+  long left = 0;
+  TaskGroup group(scheduler);
+  group.spawn([&scheduler, &left, n] { left = parallelFib(scheduler, n - 1); });
+  auto const right = parallelFib(scheduler, n - 2);
+  group.join();
+  return left + right;
+}
+
+auto parallelSort(Scheduler& scheduler, int* pBegin, int* pEnd) -> void {
+  while (pEnd - pBegin > sortCutoff) {
+    auto const pivot = pBegin[(pEnd - pBegin) / 2];
+    auto* const pMiddle = std::partition(pBegin, pEnd, [pivot](int value) { return value < pivot; });
+    auto* const pUpper = std::partition(pMiddle, pEnd, [pivot](int value) { return value == pivot; });
+
+    TaskGroup group(scheduler);
+    group.spawn([&scheduler, pBegin, pMiddle] { parallelSort(scheduler, pBegin, pMiddle); });
+    parallelSort(scheduler, pUpper, pEnd);
+    group.join();
+    return;
+  }
+  std::sort(pBegin, pEnd);
+}
+
+auto label(benchmark::State& state) { state.SetLabel(std::to_string(state.range(0)) + " worker(s)"); }
+
+auto fib(benchmark::State& state) {
+  Scheduler scheduler(static_cast<cds::Size>(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(parallelFib(scheduler, 30));
+  }
+  label(state);
+}
+
+auto quicksort(benchmark::State& state) {
+  Scheduler scheduler(static_cast<cds::Size>(state.range(0)));
+  std::vector<int> source(1u << 20u);
+  std::mt19937 engine(42u);
+  std::generate(source.begin(), source.end(), engine);
+
+  std::vector<int> values;
+  for (auto _ : state) {
+    state.PauseTiming();
+    values = source;
+    state.ResumeTiming();
+    parallelSort(scheduler, values.data(), values.data() + values.size());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<long>(source.size()));
+  label(state);
+}
+
+auto parallelFor(benchmark::State& state) {
+  Scheduler scheduler(static_cast<cds::Size>(state.range(0)));
+  std::vector<double> values(1u << 20u);
+  std::iota(values.begin(), values.end(), 0.0);
+  for (auto _ : state) {
+    age::parallelFor(scheduler, std::size_t {0u}, values.size(), std::size_t {4096u},
+                     [&values](std::size_t index) { values[index] = std::sqrt(values[index] + 1.0); });
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<long>(values.size()));
+  label(state);
+}
+
+/// \brief Argument: worker count, from 1 to the number of hardware threads.
+auto workerCounts(benchmark::internal::Benchmark* pBenchmark) {
+  auto const hardwareThreads = std::max(static_cast<long>(std::thread::hardware_concurrency()), 1L);
+  for (long workers = 1; workers < hardwareThreads; workers *= 2) {
+    pBenchmark->Arg(workers);
+  }
+  pBenchmark->Arg(hardwareThreads)->UseRealTime()->Unit(benchmark::kMillisecond);
+}
+} // namespace
+
+BENCHMARK(fib)->Apply(workerCounts);
+BENCHMARK(quicksort)->Apply(workerCounts);
+BENCHMARK(parallelFor)->Apply(workerCounts);
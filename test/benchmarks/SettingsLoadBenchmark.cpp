@@ -0,0 +1,55 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <CDS/filesystem/Path>
+#include <visualizer/settings/SettingsRegistry.hpp>
+
+namespace {
+using age::visualizer::settings::Registry;
+
+/// \brief Groups per directory of the generated config tree.
+constexpr auto const groupsPerSection = 16;
+
+/// \brief Config tree of the given number of group files, spread over section directories, each file holding a few
+/// settings of every type.
+auto makeConfigTree(long groups) {
+  auto const root = std::filesystem::temp_directory_path() / "age_settings_benchmark" / std::to_string(groups);
+  std::filesystem::remove_all(root);
+  for (long group = 0; group < groups; ++group) {
+    auto const section = root / ("section" + std::to_string(group / groupsPerSection));
+    std::filesystem::create_directories(section);
+    std::ofstream(section / ("group" + std::to_string(group) + ".json")) << R"({
+  "name" : "group",
+  "enabled" : true,
+  "width" : 1280,
+  "height" : 720,
+  "scale" : 1.5,
+  "colours" : ["#ffffff", "#000000", "#ff0000"]
+})";
+  }
+  return root;
+}
+
+auto startup(benchmark::State& state) {
+  auto const root = makeConfigTree(state.range(0));
+  cds::filesystem::Path const path(root.string().c_str());
+  for (auto _ : state) {
+    cds::json::JsonObject json;
+    Registry::loadGroups(json, path);
+    benchmark::DoNotOptimize(json);
+  }
+
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetLabel(std::to_string(state.range(0)) + " group files");
+  std::filesystem::remove_all(root);
+}
+} // namespace
+
+BENCHMARK(startup)->RangeMultiplier(10)->Range(10, 10000)->UseRealTime()->Unit(benchmark::kMillisecond);
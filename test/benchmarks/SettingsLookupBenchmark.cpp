@@ -0,0 +1,51 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <string>
+
+#include <visualizer/settings/SettingsRegistry.hpp>
+
+namespace {
+using age::visualizer::settings::Registry;
+using age::visualizer::settings::registry;
+
+/// \brief Keys of settings nested 1 to 8 groups deep, put in the registry once.
+auto const& nestedKeys() {
+  static auto const keys = [] {
+    std::array<std::string, 8u> keys;
+    std::string group = "benchmark";
+    for (auto& key : keys) {
+      key = group + ".value";
+      registry().put(key, 1280);
+      group += ".nested";
+    }
+    return keys;
+  }();
+  return keys;
+}
+
+auto lookupByString(benchmark::State& state) {
+  auto const& key = nestedKeys()[static_cast<std::size_t>(state.range(0) - 1)];
+  auto const& settings = registry();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(settings.getInt(key));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+auto lookupByKey(benchmark::State& state) {
+  Registry::Key const key {nestedKeys()[static_cast<std::size_t>(state.range(0) - 1)]};
+  auto const& settings = registry();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(settings.getInt(key));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+} // namespace
+
+BENCHMARK(lookupByString)->DenseRange(1, 8);
+BENCHMARK(lookupByKey)->DenseRange(1, 8);
@@ -0,0 +1,110 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <lang/thread/AsyncBatch.hpp>
+#include <lang/thread/Executor.hpp>
+
+namespace {
+using age::AsyncBatch;
+using age::Executor;
+} // namespace
+
+TEST(AsyncBatchTest, resultsInArgumentOrder) {
+  Executor executor(4u);
+  AsyncBatch<std::string, int, char> repeat([](int count, char character) { return std::string(count, character); },
+                                            executor);
+  std::vector<std::tuple<int, char>> arguments;
+  for (auto index = 0; index < 100; ++index) {
+    arguments.emplace_back(index, static_cast<char>('a' + index % 26));
+  }
+
+  repeat.trigger(arguments);
+  auto const results = repeat.await();
+  ASSERT_EQ(results.size(), 100u);
+  for (auto index = 0; index < 100; ++index) {
+    ASSERT_EQ(results[index], std::string(index, static_cast<char>('a' + index % 26)));
+  }
+}
+
+TEST(AsyncBatchTest, resultsInCompletionOrder) {
+  Executor executor(2u);
+  AsyncBatch<int, int> square([](int value) { return value * value; }, executor);
+  square.trigger(std::vector {1, 2, 3, 4, 5, 6, 7, 8});
+
+  std::multiset<int> results;
+  for (auto result : square.completed()) {
+    results.insert(result);
+  }
+  ASSERT_EQ(results, (std::multiset {1, 4, 9, 16, 25, 36, 49, 64}));
+}
+
+TEST(AsyncBatchTest, parallelismIsBounded) {
+  Executor executor(4u);
+  std::atomic<int> running {0};
+  std::atomic<int> peak {0};
+  AsyncBatch<void, int> batch(
+      [&running, &peak](int) {
+        auto const now = running.fetch_add(1) + 1;
+        for (auto observed = peak.load(); observed < now && !peak.compare_exchange_weak(observed, now);) {
+          // empty on purpose
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        running.fetch_sub(1);
+      },
+      executor, 2u);
+
+  ASSERT_EQ(batch.parallelism(), 2u);
+  batch.trigger(std::vector<int>(64, 0));
+  batch.await();
+  // Two executor tasks, plus the awaiting thread helping
+  ASSERT_LE(peak.load(), 3);
+}
+
+TEST(AsyncBatchTest, awaiterHelpsBusyExecutor) {
+  Executor executor(1u);
+  std::atomic<bool> release {false};
+  executor.submit([&release] {
+    while (!release.load()) {
+      std::this_thread::yield();
+    }
+  });
+
+  AsyncBatch<int, int> increment([](int value) { return value + 1; }, executor);
+  increment.trigger(std::vector {1, 2, 3});
+  ASSERT_EQ(increment.await(), (std::vector {2, 3, 4}));
+  release.store(true);
+}
+
+TEST(AsyncBatchTest, exceptionsReachTheAwaiter) {
+  Executor executor(2u);
+  std::atomic<int> ran {0};
+  AsyncBatch<int, int> checked(
+      [&ran](int value) {
+        ran.fetch_add(1);
+        if (value % 4 == 3) {
+          throw std::out_of_range(std::to_string(value));
+        }
+        return value;
+      },
+      executor);
+
+  checked.trigger(std::vector {0, 1, 2, 3, 4, 5, 6, 7});
+  try {
+    (void) checked.await();
+    FAIL();
+  } catch (std::out_of_range const& error) {
+    ASSERT_STREQ(error.what(), "3");
+  }
+  ASSERT_EQ(ran.load(), 8);
+}
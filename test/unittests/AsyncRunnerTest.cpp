@@ -5,6 +5,10 @@
 #include <gtest/gtest.h>
 #include <lang/thread/AsyncRunner.hpp>
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 namespace {
 using age::AsyncRunner;
 } // namespace
@@ -29,3 +33,34 @@ TEST(AsyncRunnerTest, returningAsync) {
   auto result = intToStringAsync.await();
   ASSERT_EQ(result, "5");
 }
+
+TEST(AsyncRunnerTest, everyAwaiterIsWoken) {
+  std::atomic<bool> release {false};
+  AsyncRunner<int> slow = [&release] {
+    while (!release.load()) {
+      std::this_thread::yield();
+    }
+    return 7;
+  };
+
+  slow.trigger();
+  std::atomic<int> sum {0};
+  std::vector<std::thread> awaiters;
+  for (auto index = 0; index < 4; ++index) {
+    awaiters.emplace_back([&slow, &sum] { sum.fetch_add(slow.await()); });
+  }
+
+  release.store(true);
+  for (auto& awaiter : awaiters) {
+    awaiter.join();
+  }
+  ASSERT_EQ(sum.load(), 28);
+}
+
+TEST(AsyncRunnerTest, destroyedRightAfterAwait) {
+  for (auto index = 0; index < 1000; ++index) {
+    AsyncRunner<int, int> increment = [](int value) { return value + 1; };
+    increment.trigger(index);
+    ASSERT_EQ(increment.await(), index + 1);
+  }
+}
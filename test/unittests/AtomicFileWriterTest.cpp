@@ -0,0 +1,83 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <lang/filesystem/AtomicFileWriter.hpp>
+
+namespace {
+using age::AtomicFileWriter;
+
+auto contentsOf(std::filesystem::path const& path) {
+  std::ifstream file(path, std::ios_base::binary);
+  return std::string {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+auto testDirectory() {
+  auto const directory = std::filesystem::temp_directory_path() / "age_atomic_file_writer_test";
+  std::filesystem::remove_all(directory);
+  std::filesystem::create_directories(directory);
+  return directory;
+}
+} // namespace
+
+TEST(AtomicFileWriterTest, replacesContents) {
+  auto const directory = testDirectory();
+  auto const path = directory / "settings.json";
+  std::ofstream(path) << "{\"previous\": true, \"longer\": \"than the replacement\"}";
+
+  AtomicFileWriter writer;
+  writer.write(path, "{\"a\": 1}");
+  writer.commit();
+
+  ASSERT_EQ(contentsOf(path), "{\"a\": 1}");
+  ASSERT_FALSE(std::filesystem::exists(directory / "settings.json.tmp"));
+  std::filesystem::remove_all(directory);
+}
+
+TEST(AtomicFileWriterTest, concurrentWrites) {
+  auto const directory = testDirectory();
+  std::filesystem::create_directories(directory / "nested");
+
+  AtomicFileWriter writer;
+  std::vector<std::thread> threads;
+  for (auto index = 0; index < 8; ++index) {
+    threads.emplace_back([&writer, &directory, index] {
+      auto const parent = index % 2 == 0 ? directory : directory / "nested";
+      writer.write(parent / (std::to_string(index) + ".json"), std::to_string(index));
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  writer.commit();
+
+  for (auto index = 0; index < 8; ++index) {
+    auto const parent = index % 2 == 0 ? directory : directory / "nested";
+    ASSERT_EQ(contentsOf(parent / (std::to_string(index) + ".json")), std::to_string(index));
+  }
+  std::filesystem::remove_all(directory);
+}
+
+TEST(AtomicFileWriterTest, failureKeepsTarget) {
+  auto const directory = testDirectory();
+  AtomicFileWriter writer;
+  ASSERT_THROW(writer.write(directory / "missing" / "settings.json", "{}"), std::ios_base::failure);
+
+  // A directory in the way of the rename: the write fails and leaves no temporary file behind
+  std::filesystem::create_directories(directory / "settings.json" / "entry");
+  ASSERT_THROW(writer.write(directory / "settings.json", "{}"), std::ios_base::failure);
+  ASSERT_TRUE(std::filesystem::is_directory(directory / "settings.json"));
+  ASSERT_FALSE(std::filesystem::exists(directory / "settings.json.tmp"));
+  writer.commit();
+  std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,115 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include <core/logging/BinaryLogFormat.hpp>
+#include <core/logging/Logger.hpp>
+
+namespace {
+using age::Logger;
+using age::LoggerOutput;
+using age::meta::decodeBinaryLog;
+
+auto appendWord(std::string& into, unsigned value) {
+  for (auto index = 0; index < 4; ++index) {
+    into.push_back(static_cast<char>((value >> (index * 8)) & 0xFFu));
+  }
+}
+
+auto site(unsigned id, unsigned fileLength, unsigned functionLength) {
+  std::string entry("\x01", 1u);
+  for (auto value : {id, 1u, 1u, fileLength, functionLength}) {
+    appendWord(entry, value);
+  }
+  return entry;
+}
+
+auto decode(std::string const& binary) {
+  std::stringstream in(binary);
+  std::stringstream out;
+  auto const valid = decodeBinaryLog(in, out);
+  return std::make_pair(valid, out.str());
+}
+} // namespace
+
+#ifndef NDEBUG
+TEST(BinaryLogFormatTest, decodesToTextLayout) {
+  using enum age::meta::LogOptionFlagBits;
+  std::stringstream text;
+  std::stringstream binary;
+  auto logger = Logger::get(LoggerOutput(text), LoggerOutput::binary(binary));
+
+  for (auto options : {Logger::defaultOptionFlags,
+                       SourceLocation | SourceLocationFunction | SourceLocationColumn | InfoPrefix | LoggerName,
+                       TimestampNanoseconds | MonotonicTimestamp | LogLevel | ThreadId}) {
+    logger.setOptions(options);
+    for (auto index = 0; index < 3; ++index) {
+      logger(Logger::Level::Warning) << "record " << index << ' ' << 2.5;
+    }
+    logger() << "";
+  }
+
+  auto const [valid, decoded] = decode(binary.str());
+  ASSERT_TRUE(valid);
+  ASSERT_EQ(decoded, text.str());
+}
+
+TEST(BinaryLogFormatTest, skipsTextHeaderForBinaryOnly) {
+  std::stringstream text;
+  std::stringstream binary;
+  auto logger = Logger::get(LoggerOutput(text, LoggerOutput::allowError), LoggerOutput::binary(binary));
+  logger.disableOptions(Logger::OptionFlag::ThreadId);
+
+  logger(Logger::Level::Info) << "binary only";
+  logger(Logger::Level::Error) << "both";
+
+  auto const [valid, decoded] = decode(binary.str());
+  ASSERT_TRUE(valid);
+  ASSERT_NE(decoded.find("binary only"), std::string::npos);
+  ASSERT_EQ(decoded.substr(decoded.find('\n') + 1u), text.str());
+}
+#endif
+
+TEST(BinaryLogFormatTest, rejectsUnknownSites) {
+  std::stringstream binary;
+  ASSERT_THROW(age::meta::writeBinaryLogRecord(binary, 0xFFFFFFFFu, "record"), std::out_of_range);
+  ASSERT_TRUE(binary.str().empty());
+}
+
+TEST(BinaryLogFormatTest, rejectsMalformedInput) {
+  ASSERT_FALSE(decode("").first);
+  ASSERT_FALSE(decode("NOTALOG!").first);
+  ASSERT_TRUE(decode(std::string("AGELOG\x01\x00", 8u)).first);
+  ASSERT_FALSE(decode(std::string("AGELOG\x01\x00\x02\x00", 10u)).first);
+  ASSERT_FALSE(decode(std::string("AGELOG\x01\x00\x07", 9u)).first);
+}
+
+TEST(BinaryLogFormatTest, rejectsCorruptLengthsAndSites) {
+  std::string const magic("AGELOG\x01\x00", 8u);
+  ASSERT_TRUE(decode(magic + site(0u, 1u, 1u) + "ff" + site(1u, 0u, 0u) + site(0u, 0u, 0u)).first);
+  ASSERT_FALSE(decode(magic + site(2u, 0u, 0u)).first);
+  ASSERT_FALSE(decode(magic + site(0xFFFFFFFFu, 0u, 0u)).first);
+  ASSERT_FALSE(decode(magic + site(0u, 0xFFFFFFF0u, 0u) + "truncated").first);
+  ASSERT_FALSE(decode(magic + site(0u, 0u, 0xFFFFFFF0u)).first);
+
+  std::string record("\x02", 1u);
+  for (auto value : {0u, 0u, 1u, 0u, 0u, 0u, 0u, 0xFFFFFFF0u, 0xFFFFFFF0u}) {
+    appendWord(record, value);
+  }
+  ASSERT_FALSE(decode(magic + site(0u, 0u, 0u) + record).first);
+}
+
+TEST(BinaryLogFormatTest, skipsPaddingAndRestartedLogs) {
+  std::string const magic("AGELOG\x01\x00", 8u);
+  std::string const padding(32u, '\0');
+  ASSERT_TRUE(decode(magic + site(0u, 0u, 0u) + padding + magic + site(0u, 0u, 0u) + padding).first);
+  ASSERT_FALSE(decode(magic + padding + site(1u, 0u, 0u)).first);
+  ASSERT_FALSE(decode(magic + site(0u, 0u, 0u) + magic + site(1u, 0u, 0u)).first);
+  ASSERT_FALSE(decode(magic + "AGELOG\x02").first);
+}
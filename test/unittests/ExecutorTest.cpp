@@ -0,0 +1,60 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <lang/thread/AsyncRunner.hpp>
+#include <lang/thread/Executor.hpp>
+
+namespace {
+using age::AsyncRunner;
+using age::Executor;
+} // namespace
+
+TEST(ExecutorTest, runsEveryTask) {
+  std::atomic<int> sum {0};
+  {
+    Executor executor(4u);
+    ASSERT_EQ(executor.threadCount(), 4u);
+    for (auto index = 1; index <= 1000; ++index) {
+      executor.submit([&sum, index] { sum.fetch_add(index, std::memory_order_relaxed); });
+    }
+  }
+  ASSERT_EQ(sum.load(), 500500);
+}
+
+TEST(ExecutorTest, reusesWorkers) {
+  Executor executor(2u);
+  std::mutex mutex;
+  std::set<std::thread::id> workers;
+  std::atomic<int> done {0};
+  for (auto index = 0; index < 64; ++index) {
+    executor.submit([&] {
+      {
+        std::lock_guard lock(mutex);
+        workers.insert(std::this_thread::get_id());
+      }
+      done.fetch_add(1, std::memory_order_release);
+    });
+  }
+
+  while (done.load(std::memory_order_acquire) != 64) {
+    std::this_thread::yield();
+  }
+  ASSERT_LE(workers.size(), 2u);
+}
+
+TEST(ExecutorTest, asyncRunnerRetrigger) {
+  Executor executor(1u);
+  AsyncRunner<int, int> square([](int value) { return value * value; }, executor);
+  for (auto value = 0; value < 100; ++value) {
+    square.trigger(value);
+    ASSERT_EQ(square.await(), value * value);
+  }
+}
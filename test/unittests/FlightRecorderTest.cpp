@@ -0,0 +1,212 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <csignal>
+#include <cstdlib>
+#include <latch>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include <core/logging/FlightRecorder.hpp>
+
+namespace {
+using age::FlightRecorder;
+using age::FlightRecorderConfig;
+using age::Logger;
+using age::LoggerOutput;
+using Level = age::meta::LogLevelFlagBits;
+
+auto lines(std::string const& text) {
+  std::vector<std::string> result;
+  std::stringstream in(text);
+  for (std::string line; std::getline(in, line);) {
+    result.push_back(line);
+  }
+  return result;
+}
+} // namespace
+
+TEST(FlightRecorderTest, keepsRecordsUntilDumped) {
+  std::stringstream out;
+  FlightRecorder recorder(out);
+  recorder.record(Level::Debug, "first");
+  recorder.record(Level::Info, "second");
+  ASSERT_EQ(out.str(), "");
+
+  recorder.dump();
+  ASSERT_EQ(out.str(), "first\nsecond\n");
+
+  recorder.record(Level::Warning, "third");
+  recorder.dump();
+  ASSERT_EQ(out.str(), "first\nsecond\nthird\n");
+}
+
+TEST(FlightRecorderTest, dumpsOnError) {
+  std::stringstream out;
+  FlightRecorder recorder(out);
+  recorder.record(Level::Debug, "context");
+  recorder.record(Level::Error, "failure");
+  ASSERT_EQ(out.str(), "context\nfailure\n");
+
+  FlightRecorderConfig config;
+  config.dumpOnError = false;
+  std::stringstream quiet;
+  FlightRecorder onDemand(quiet, config);
+  onDemand.record(Level::Error, "failure");
+  ASSERT_EQ(quiet.str(), "");
+}
+
+TEST(FlightRecorderTest, countsFailedDumps) {
+  struct FailingBuffer : std::streambuf {
+    auto overflow(int_type) -> int_type override { return traits_type::eof(); }
+  } buffer;
+  std::ostream out(&buffer);
+  out.exceptions(std::ios::badbit);
+
+  FlightRecorder recorder(out);
+  recorder.record(Level::Debug, "context");
+  recorder.record(Level::Error, "failure");
+  ASSERT_EQ(recorder.failedDumps(), 1u);
+}
+
+TEST(FlightRecorderTest, overwritesOldest) {
+  FlightRecorderConfig config;
+  config.recordsPerThread = 4u;
+  config.recordSize = 8u;
+  std::stringstream out;
+  FlightRecorder recorder(out, config);
+  for (auto index = 0; index < 10; ++index) {
+    recorder.record(Level::Debug, "record " + std::to_string(index));
+  }
+  recorder.record(Level::Debug, "truncated record");
+
+  recorder.dump();
+  ASSERT_EQ(out.str(), "record 7\nrecord 8\nrecord 9\ntruncate\n");
+}
+
+TEST(FlightRecorderTest, ringPerThread) {
+  FlightRecorderConfig config;
+  config.recordsPerThread = 16u;
+  config.threads = 4u;
+  std::stringstream out;
+  FlightRecorder recorder(out, config);
+
+  // Threads stay alive until all of them recorded, so that no ring is handed back in between
+  std::latch recorded(6);
+  std::vector<std::thread> threads;
+  for (auto index = 0; index < 6; ++index) {
+    threads.emplace_back([&recorder, &recorded, index] {
+      for (auto record = 0; record < 8; ++record) {
+        recorder.record(Level::Debug, "thread " + std::to_string(index));
+      }
+      recorded.arrive_and_wait();
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  recorder.dump();
+  ASSERT_EQ(lines(out.str()).size(), 4u * 8u);
+  ASSERT_EQ(recorder.dropped(), 2u * 8u);
+}
+
+TEST(FlightRecorderTest, reusesRingsOfExitedThreads) {
+  FlightRecorderConfig config;
+  config.recordsPerThread = 4u;
+  config.threads = 1u;
+  std::stringstream out;
+  FlightRecorder recorder(out, config);
+
+  for (auto index = 0; index < 3; ++index) {
+    std::thread([&recorder, index] { recorder.record(Level::Debug, "thread " + std::to_string(index)); }).join();
+  }
+
+  {
+    // Threads outliving the recorder do not touch its rings on exit
+    std::optional<FlightRecorder> shortLived(std::in_place, out, config);
+    std::latch recorded(1);
+    std::latch destroyed(1);
+    std::thread thread([&shortLived, &recorded, &destroyed] {
+      shortLived->record(Level::Debug, "short lived");
+      recorded.count_down();
+      destroyed.wait();
+    });
+    recorded.wait();
+    shortLived.reset();
+    destroyed.count_down();
+    thread.join();
+  }
+
+  recorder.dump();
+  ASSERT_EQ(out.str(), "thread 0\nthread 1\nthread 2\n");
+  ASSERT_EQ(recorder.dropped(), 0u);
+}
+
+#ifndef NDEBUG
+TEST(FlightRecorderTest, loggerOutput) {
+  std::stringstream dump;
+  std::stringstream console;
+  FlightRecorder recorder(dump);
+  auto logger = Logger::get(LoggerOutput(console, LoggerOutput::allowError | LoggerOutput::allowWarning),
+                            LoggerOutput(recorder, LoggerOutput::allowAll & ~LoggerOutput::allowWarning));
+  logger.disableOptions(Logger::defaultOptionFlags);
+  logger.enableOptions(Logger::OptionFlag::LogLevel);
+
+  logger(Logger::Level::Debug) << "verbose " << 1;
+  logger(Logger::Level::Warning) << "console only";
+  ASSERT_EQ(dump.str(), "");
+
+  logger(Logger::Level::Error) << "failed";
+  ASSERT_EQ(dump.str(), "[Debug] verbose 1\n[Error] failed\n");
+  ASSERT_EQ(console.str(), "[Warning] console only\n[Error] failed\n");
+}
+
+#if defined(__linux) | defined(__APPLE__)
+TEST(FlightRecorderTest, dumpsOnFatalSignal) {
+  std::stringstream dump;
+  FlightRecorder recorder(dump);
+  auto logger = Logger::get();
+  logger.outputs().clear();
+  logger.outputs().emplace(recorder);
+  logger.disableOptions(Logger::defaultOptionFlags);
+
+  ASSERT_DEATH(
+      {
+        (void) recorder.dumpOnFatalSignal(2);
+        logger() << "last words";
+        std::abort();
+      },
+      "last words");
+}
+
+TEST(FlightRecorderTest, chainsPreviousSignalHandler) {
+  std::stringstream dump;
+  FlightRecorder recorder(dump);
+  recorder.record(Level::Info, "last words");
+
+  ASSERT_DEATH(
+      {
+        struct sigaction previous {};
+        previous.sa_handler = [](int) {
+          constexpr char const message[] = "previous handler\n";
+          (void) write(2, message, sizeof(message) - 1u);
+          std::_Exit(1);
+        };
+        sigemptyset(&previous.sa_mask);
+        (void) sigaction(SIGABRT, &previous, nullptr);
+        (void) recorder.dumpOnFatalSignal(2);
+        std::abort();
+      },
+      "last words\nprevious handler");
+}
+#endif
+#endif
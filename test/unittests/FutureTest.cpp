@@ -0,0 +1,146 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <lang/thread/Future.hpp>
+
+namespace {
+using age::Executor;
+using age::Future;
+using age::Promise;
+
+struct CountedCopies {
+  explicit CountedCopies(std::atomic<int>& copies) : pCopies(&copies) {}
+  CountedCopies(CountedCopies const& other) : pCopies(other.pCopies) { pCopies->fetch_add(1); }
+  CountedCopies(CountedCopies&&) noexcept = default;
+
+  auto operator()(int value) const { return value + 1; }
+
+  std::atomic<int>* pCopies;
+};
+} // namespace
+
+TEST(FutureTest, continuationsRunOnceSet) {
+  Executor executor(2u);
+  Promise<int> promise;
+  auto doubled = promise.future().then([](int value) { return value * 2; }, executor);
+  auto text = doubled.then([](int value) { return std::to_string(value); }, executor);
+  ASSERT_FALSE(text.ready());
+
+  ASSERT_TRUE(promise.setValue(21));
+  ASSERT_FALSE(promise.setValue(0));
+  ASSERT_EQ(text.get(), "42");
+  ASSERT_EQ(doubled.get(), 42);
+  ASSERT_EQ(promise.future().get(), 21);
+}
+
+TEST(FutureTest, continuationsAreMoved) {
+  Executor executor(1u);
+  std::atomic<int> copies {0};
+  Promise<int> promise;
+  auto next = promise.future().then(CountedCopies(copies), executor);
+  ASSERT_TRUE(promise.setValue(1));
+  ASSERT_EQ(next.get(), 2);
+  ASSERT_EQ(copies.load(), 0);
+}
+
+TEST(FutureTest, voidChain) {
+  Executor executor(1u);
+  std::atomic<int> steps {0};
+  auto done = age::runAsync([&steps] { steps.fetch_add(1); }, executor)
+                  .then([&steps] { steps.fetch_add(1); }, executor)
+                  .then([&steps] { return steps.load(); }, executor);
+  ASSERT_EQ(done.get(), 2);
+}
+
+TEST(FutureTest, exceptionsSkipContinuations) {
+  Executor executor(1u);
+  auto called = false;
+  auto failed = age::runAsync([]() -> int { throw std::runtime_error("load failed"); }, executor)
+                    .then([&called](int value) {
+                      called = true;
+                      return value;
+                    }, executor);
+  ASSERT_THROW((void) failed.get(), std::runtime_error);
+  ASSERT_FALSE(called);
+
+  auto throwing =
+      age::runAsync([] { return 1; }, executor).then([](int) -> int { throw std::logic_error("bad"); }, executor);
+  ASSERT_THROW((void) throwing.get(), std::logic_error);
+}
+
+TEST(FutureTest, brokenPromise) {
+  Future<int> future;
+  ASSERT_FALSE(future.valid());
+  {
+    Promise<int> promise;
+    future = promise.future();
+  }
+
+  ASSERT_TRUE(future.ready());
+  try {
+    (void) future.get();
+    FAIL();
+  } catch (std::future_error const& error) {
+    ASSERT_EQ(error.code(), std::future_errc::broken_promise);
+  }
+}
+
+TEST(FutureTest, unwrapsReturnedFutures) {
+  Executor executor(2u);
+  Promise<int> saved;
+  auto reloaded = saved.future().then(
+      [&executor](int version) { return age::runAsync([version] { return version + 1; }, executor); }, executor);
+
+  static_assert(std::is_same_v<decltype(reloaded), Future<int>>);
+  ASSERT_TRUE(saved.setValue(1));
+  ASSERT_EQ(reloaded.get(), 2);
+}
+
+TEST(FutureTest, whenAll) {
+  Executor executor(4u);
+  std::vector<Future<int>> futures;
+  for (auto index = 0; index < 16; ++index) {
+    futures.push_back(age::runAsync([index] { return index * index; }, executor));
+  }
+
+  auto const squares = age::whenAll(futures).get();
+  ASSERT_EQ(squares.size(), 16u);
+  for (auto index = 0; index < 16; ++index) {
+    ASSERT_EQ(squares[index], index * index);
+  }
+
+  futures.push_back(age::runAsync([]() -> int { throw std::runtime_error("one failed"); }, executor));
+  ASSERT_THROW((void) age::whenAll(futures).get(), std::runtime_error);
+  ASSERT_TRUE(age::whenAll(std::vector<Future<int>> {}).get().empty());
+
+  std::atomic<int> count {0};
+  std::vector<Future<void>> tasks;
+  for (auto index = 0; index < 8; ++index) {
+    tasks.push_back(age::runAsync([&count] { count.fetch_add(1); }, executor));
+  }
+  age::whenAll(tasks).get();
+  ASSERT_EQ(count.load(), 8);
+}
+
+TEST(FutureTest, whenAny) {
+  Promise<int> slow;
+  Promise<int> fast;
+  auto first = age::whenAny(std::vector {slow.future(), fast.future()});
+  ASSERT_FALSE(first.ready());
+
+  ASSERT_TRUE(fast.setValue(2));
+  ASSERT_EQ(first.get(), 1u);
+  ASSERT_TRUE(slow.setValue(1));
+  ASSERT_EQ(first.get(), 1u);
+
+  ASSERT_THROW((void) age::whenAny(std::vector<Future<int>> {}).get(), std::future_error);
+}
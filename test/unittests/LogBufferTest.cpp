@@ -0,0 +1,137 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <new>
+#include <sstream>
+#include <string>
+
+#include <core/logging/LogBuffer.hpp>
+#include <core/logging/Logger.hpp>
+
+namespace {
+using age::Logger;
+using age::meta::LogBuffer;
+using age::meta::LogStreamBuffer;
+
+/// Allocations are only counted on a thread inside a CountedAllocations scope, so replacing the global operator new
+/// leaves the other tests of the binary unaffected.
+thread_local bool countAllocations = false;
+thread_local cds::Size allocations = 0u;
+
+struct CountedAllocations {
+  CountedAllocations() noexcept { countAllocations = true; }
+  CountedAllocations(CountedAllocations const&) = delete;
+  CountedAllocations(CountedAllocations&&) = delete;
+  ~CountedAllocations() noexcept { countAllocations = false; }
+
+  auto operator=(CountedAllocations const&) = delete;
+  auto operator=(CountedAllocations&&) = delete;
+};
+
+class NullBuffer : public std::streambuf {
+protected:
+  auto overflow(int_type character) -> int_type override { return traits_type::not_eof(character); }
+  auto xsputn(char const* data, std::streamsize count) -> std::streamsize override {
+    (void) data;
+    return count;
+  }
+};
+
+#ifndef NDEBUG
+struct Nested {
+  Logger* pLogger;
+};
+
+auto operator<<(std::ostream& out, Nested const& nested) -> std::ostream& {
+  (*nested.pLogger)() << "inner";
+  return out << "outer";
+}
+#endif
+
+auto contents(LogBuffer& buffer) { return std::string(buffer.contents().data(), buffer.contents().size()); }
+} // namespace
+
+// Kept out of line, so that inlining never pairs a new expression with the std::free below
+#if defined(__GNUC__)
+#define AGE_ALLOCATION_HOOK [[gnu::noinline]]
+#else
+#define AGE_ALLOCATION_HOOK
+#endif
+
+AGE_ALLOCATION_HOOK auto operator new(std::size_t size) -> void* {
+  if (countAllocations) {
+    ++allocations;
+  }
+
+  if (auto* pMemory = std::malloc(size == 0u ? 1u : size)) {
+    return pMemory;
+  }
+  throw std::bad_alloc();
+}
+
+AGE_ALLOCATION_HOOK auto operator delete(void* pMemory) noexcept -> void { std::free(pMemory); }
+AGE_ALLOCATION_HOOK auto operator delete(void* pMemory, std::size_t size) noexcept -> void {
+  (void) size;
+  std::free(pMemory);
+}
+
+TEST(LogBufferTest, inlineContents) {
+  LogBuffer buffer;
+  buffer.stream() << "value " << 42;
+  ASSERT_EQ(contents(buffer), "value 42");
+
+  buffer.reset();
+  ASSERT_TRUE(buffer.contents().empty());
+}
+
+TEST(LogBufferTest, spillKeepsOrder) {
+  LogBuffer buffer;
+  std::string const large(LogStreamBuffer::inlineCapacity * 3u, 'x');
+  buffer.stream() << "head " << large << " tail" << '!';
+  ASSERT_EQ(contents(buffer), "head " + large + " tail!");
+
+  buffer.reset();
+  buffer.stream() << "short";
+  ASSERT_EQ(contents(buffer), "short");
+}
+
+TEST(LogBufferTest, resetRestoresFormatting) {
+  LogBuffer buffer;
+  buffer.stream() << std::hex << 255;
+  buffer.reset();
+  buffer.stream() << 255;
+  ASSERT_EQ(contents(buffer), "255");
+}
+
+#ifndef NDEBUG
+TEST(LogBufferTest, nestedRecords) {
+  std::stringstream outbuf;
+  auto logger = Logger::get(outbuf);
+  logger.disableOptions(Logger::defaultOptionFlags);
+  logger() << "before " << Nested {&logger} << " after";
+  ASSERT_EQ(outbuf.str(), "inner\nbefore outer after\n");
+}
+#endif
+
+TEST(LogBufferTest, steadyStateDoesNotAllocate) {
+  using enum age::meta::LogOptionFlagBits;
+  NullBuffer sink;
+  std::ostream out(&sink);
+  auto logger = Logger::get(out);
+  logger.setOptions(SourceLocation | Timestamp | TimestampMicroseconds | LoggerName | LogLevel | ThreadId);
+
+  std::string const large(LogStreamBuffer::inlineCapacity * 2u, 'x');
+  logger() << "warm-up " << 1 << ' ' << 2.5 << large;
+
+  CountedAllocations const counted;
+  auto const before = allocations;
+  for (auto index = 0; index < 100; ++index) {
+    logger() << "steady " << index << ' ' << 2.5 << std::hex << index;
+    logger(Logger::Level::Error) << large;
+  }
+  ASSERT_EQ(allocations, before);
+}
@@ -0,0 +1,80 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <sstream>
+#include <string>
+
+#include <core/logging/LogFormat.hpp>
+
+namespace {
+using age::meta::formatLogArguments;
+using age::meta::invalidLogFormat;
+using age::meta::LogArguments;
+using age::meta::logFormatPlaceholders;
+
+template <typename... Args> auto format(std::string_view format, Args const&... args) {
+  std::stringstream out;
+  formatLogArguments(out, format, args...);
+  return out.str();
+}
+
+auto render(LogArguments const& arguments) {
+  std::stringstream out;
+  arguments.render(out);
+  return out.str();
+}
+
+struct Streamed {
+  int value;
+};
+
+auto operator<<(std::ostream& out, Streamed const& streamed) -> std::ostream& {
+  return out << "streamed " << streamed.value;
+}
+} // namespace
+
+TEST(LogFormatTest, placeholders) {
+  static_assert(logFormatPlaceholders("") == 0u);
+  static_assert(logFormatPlaceholders("no placeholders") == 0u);
+  static_assert(logFormatPlaceholders("{} and {}") == 2u);
+  static_assert(logFormatPlaceholders("{{}} {}") == 1u);
+  static_assert(logFormatPlaceholders("{") == invalidLogFormat);
+  static_assert(logFormatPlaceholders("} {}") == invalidLogFormat);
+  static_assert(logFormatPlaceholders("{0}") == invalidLogFormat);
+  ASSERT_EQ(logFormatPlaceholders("{}{}{}"), 3u);
+}
+
+TEST(LogFormatTest, formatting) {
+  ASSERT_EQ(format("plain"), "plain");
+  ASSERT_EQ(format("{} + {} = {}", 1, 2, 3), "1 + 2 = 3");
+  ASSERT_EQ(format("{}{}", "a", std::string("b")), "ab");
+  ASSERT_EQ(format("{{{}}}", 5), "{5}");
+  ASSERT_EQ(format("value: {}", Streamed {7}), "value: streamed 7");
+}
+
+TEST(LogFormatTest, deferredArgumentsAreCopies) {
+  std::string text = "before";
+  LogArguments arguments {"{} {}", text, text.c_str()};
+  text = "after, long enough to reallocate the buffer";
+  ASSERT_EQ(render(arguments), "before before");
+}
+
+TEST(LogFormatTest, deferredArgumentsMove) {
+  LogArguments inlined {"{} {}", 1, Streamed {2}};
+  LogArguments spilled {"{} {} {}", std::string("spilled"), std::string("into"), std::string("heap")};
+
+  LogArguments moved {std::move(inlined)};
+  ASSERT_FALSE(inlined);
+  ASSERT_EQ(render(moved), "1 streamed 2");
+
+  moved = std::move(spilled);
+  ASSERT_FALSE(spilled);
+  ASSERT_EQ(render(moved), "spilled into heap");
+
+  moved.reset();
+  ASSERT_FALSE(moved);
+  ASSERT_EQ(render(moved), "");
+}
@@ -0,0 +1,124 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include <core/logging/LogQueue.hpp>
+
+namespace {
+using age::LogQueue;
+using Policy = age::LogQueue<int>::OverflowPolicy;
+
+auto drain(LogQueue<int>& queue) {
+  std::vector<int> values;
+  while (queue.pop([&values](int value) { values.push_back(value); })) {
+    // collect everything
+  }
+  return values;
+}
+} // namespace
+
+TEST(LogQueueTest, capacityRoundsToPowerOfTwo) {
+  LogQueue<int> queue(5u);
+  ASSERT_EQ(queue.capacity(), 8u);
+  ASSERT_EQ(queue.policy(), Policy::Block);
+}
+
+TEST(LogQueueTest, fifo) {
+  LogQueue<int> queue(4u);
+  for (int value = 0; value < 4; ++value) {
+    ASSERT_TRUE(queue.push([value](int& slot) { slot = value; }));
+  }
+
+  ASSERT_EQ(drain(queue), (std::vector<int> {0, 1, 2, 3}));
+  ASSERT_FALSE(queue.pop([](int) {}));
+}
+
+TEST(LogQueueTest, dropNewest) {
+  LogQueue<int> queue(2u, Policy::DropNewest);
+  ASSERT_TRUE(queue.push([](int& slot) { slot = 1; }));
+  ASSERT_TRUE(queue.push([](int& slot) { slot = 2; }));
+  ASSERT_FALSE(queue.push([](int& slot) { slot = 3; }));
+  ASSERT_EQ(queue.dropped(), 1u);
+  ASSERT_EQ(drain(queue), (std::vector<int> {1, 2}));
+}
+
+TEST(LogQueueTest, dropOldest) {
+  LogQueue<int> queue(2u, Policy::DropOldest);
+  for (int value = 1; value <= 5; ++value) {
+    ASSERT_TRUE(queue.push([value](int& slot) { slot = value; }));
+  }
+  ASSERT_EQ(queue.dropped(), 3u);
+  ASSERT_EQ(drain(queue), (std::vector<int> {4, 5}));
+}
+
+TEST(LogQueueTest, dropOldestEvicts) {
+  LogQueue<int> queue(2u, Policy::DropOldest);
+  std::vector<int> evicted;
+  for (int value = 1; value <= 5; ++value) {
+    ASSERT_TRUE(queue.push([value](int& slot) { slot = value; }, [&evicted](int& slot) { evicted.push_back(slot); }));
+  }
+  ASSERT_EQ(evicted, (std::vector<int> {1, 2, 3}));
+  ASSERT_EQ(drain(queue), (std::vector<int> {4, 5}));
+}
+
+TEST(LogQueueTest, throwingFill) {
+  LogQueue<int> queue(2u);
+  ASSERT_TRUE(queue.push([](int& slot) { slot = 1; }));
+  ASSERT_THROW((void) queue.push([](int&) { throw std::bad_alloc(); }), std::bad_alloc);
+  ASSERT_EQ(queue.dropped(), 1u);
+  ASSERT_EQ(drain(queue), (std::vector<int> {1}));
+
+  ASSERT_THROW((void) queue.push([](int&) { throw std::bad_alloc(); }), std::bad_alloc);
+  ASSERT_TRUE(queue.push([](int& slot) { slot = 2; }));
+  ASSERT_EQ(drain(queue), (std::vector<int> {2}));
+  ASSERT_FALSE(queue.pop([](int) {}));
+}
+
+TEST(LogQueueTest, blockingProducers) {
+  constexpr int producers = 4;
+  constexpr int perProducer = 10000;
+  LogQueue<int> queue(16u);
+  std::atomic<long long> sum {0};
+  std::atomic<bool> done {false};
+
+  std::thread consumer([&] {
+    while (true) {
+      auto const snapshot = queue.pushSnapshot();
+      while (queue.pop([&sum](int value) { sum.fetch_add(value, std::memory_order_relaxed); })) {
+        queue.complete();
+      }
+      if (done.load()) {
+        return;
+      }
+      queue.awaitPush(snapshot);
+    }
+  });
+
+  std::vector<std::thread> threads;
+  for (int index = 0; index < producers; ++index) {
+    threads.emplace_back([&queue] {
+      for (int value = 1; value <= perProducer; ++value) {
+        (void) queue.push([value](int& slot) { slot = value; });
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  queue.awaitDrained();
+  done.store(true);
+  queue.interrupt();
+  consumer.join();
+
+  ASSERT_EQ(queue.dropped(), 0u);
+  ASSERT_EQ(sum.load(), static_cast<long long>(producers) * perProducer * (perProducer + 1) / 2);
+}
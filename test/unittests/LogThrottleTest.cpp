@@ -0,0 +1,69 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <utility>
+
+#include <core/logging/LogThrottle.hpp>
+
+namespace {
+using age::meta::LogThrottle;
+using age::meta::LogThrottleConfig;
+} // namespace
+
+TEST(LogThrottleTest, fixedWindow) {
+  LogThrottle throttle;
+  LogThrottleConfig config;
+  config.rateLimit = 2u;
+  config.window = std::chrono::milliseconds(100);
+
+  ASSERT_TRUE(throttle.admit(config, 1000u));
+  ASSERT_TRUE(throttle.admit(config, 1010u));
+  ASSERT_FALSE(throttle.admit(config, 1050u));
+  ASSERT_FALSE(throttle.admit(config, 1099u));
+  ASSERT_TRUE(throttle.admit(config, 1100u));
+}
+
+TEST(LogThrottleTest, sampling) {
+  LogThrottle throttle;
+  LogThrottleConfig config;
+  config.sampleEvery = 3u;
+
+  std::string admitted;
+  for (auto index = 0; index < 7; ++index) {
+    admitted += throttle.admit(config, 0u) ? '1' : '0';
+  }
+  ASSERT_EQ(admitted, "1001001");
+}
+
+TEST(LogThrottleTest, reportOncePerWindow) {
+  LogThrottle throttle;
+  LogThrottleConfig config;
+  config.rateLimit = 1u;
+  config.window = std::chrono::milliseconds(100);
+
+  ASSERT_TRUE(throttle.admit(config, 1000u));
+  ASSERT_EQ(throttle.report(config, 1000u), 0u);
+  ASSERT_FALSE(throttle.admit(config, 1001u));
+  ASSERT_FALSE(throttle.admit(config, 1002u));
+  ASSERT_EQ(throttle.report(config, 1050u), 0u);
+  ASSERT_EQ(throttle.report(config, 1100u), 2u);
+  ASSERT_EQ(throttle.report(config, 1300u), 0u);
+}
+
+TEST(LogThrottleTest, siteTable) {
+  auto const first = std::source_location::current();
+  auto const second = std::source_location::current();
+  ASSERT_NE(age::meta::siteThrottle(first), nullptr);
+  ASSERT_EQ(age::meta::siteThrottle(first), age::meta::siteThrottle(first));
+  ASSERT_NE(age::meta::siteThrottle(first), age::meta::siteThrottle(second));
+
+  // Sites on one line only differ by their column
+  auto const [left, right] = std::make_pair(std::source_location::current(), std::source_location::current());
+  ASSERT_NE(left.column(), right.column());
+  ASSERT_NE(age::meta::siteThrottle(left), age::meta::siteThrottle(right));
+  ASSERT_EQ(age::meta::siteThrottle(right), age::meta::siteThrottle(right));
+}
@@ -4,9 +4,21 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include <CDS/Function>
 #include <CDS/threading/Thread>
 
+#include <core/logging/BinaryLogFormat.hpp>
 #include <core/logging/Logger.hpp>
 
 namespace {
@@ -191,6 +203,76 @@ auto filterMixedOut() {
   logger(Debug) << "test4";
   return std::make_tuple(infWrn.str(), wrnErr.str(), errDbg.str());
 }
+
+struct CountedFormat {
+  int* pCount;
+};
+
+/// \brief Only formatted by loggers whose levels were not compiled out.
+[[maybe_unused]] auto operator<<(ostream& out, CountedFormat const& counted) -> ostream& {
+  ++*counted.pCount;
+  return out << "counted";
+}
+
+#ifndef NDEBUG
+class GatedBuffer : public stringbuf {
+public:
+  auto awaitBlocked() const {
+    while (!_blocked.load()) {
+      _blocked.wait(false);
+    }
+  }
+
+  auto open() {
+    _open.store(true);
+    _open.notify_all();
+  }
+
+protected:
+  auto xsputn(char const* data, streamsize count) -> streamsize override {
+    block();
+    return stringbuf::xsputn(data, count);
+  }
+
+  auto overflow(int_type character) -> int_type override {
+    block();
+    return stringbuf::overflow(character);
+  }
+
+private:
+  auto block() -> void {
+    _blocked.store(true);
+    _blocked.notify_all();
+    while (!_open.load()) {
+      _open.wait(false);
+    }
+  }
+
+  atomic<bool> _blocked {false};
+  atomic<bool> _open {false};
+};
+
+/// \brief Reconfigures the asynchronous queue for one test writing through a gate. Even if an assertion fails, the
+/// gate is opened and the queue drained before the test's streams go away, and the default queue is restored.
+class AsyncConfiguration {
+public:
+  AsyncConfiguration(cds::Size capacity, Logger::OverflowPolicy policy, GatedBuffer& gate) : _gate(gate) {
+    Logger::configureAsync(capacity, policy);
+  }
+
+  AsyncConfiguration(AsyncConfiguration const&) = delete;
+  ~AsyncConfiguration() {
+    _gate.open();
+    Logger::flush();
+    Logger::configureAsync(8192u);
+  }
+
+  auto operator=(AsyncConfiguration const&) = delete;
+
+private:
+  GatedBuffer& _gate;
+};
+#endif
 } // namespace
 
 #ifndef NDEBUG
@@ -507,6 +589,102 @@ TEST(LoggerTest, namedLogger) {
   ASSERT_FALSE(outbuf2.str().find(("final test")) != std::string::npos);
 }
 
+TEST(LoggerTest, namedLoggerConcurrentLookup) {
+  constexpr auto const threadCount = 8;
+  constexpr auto const nameCount = 300;
+  vector<string> names;
+  for (auto index = 0; index < nameCount; ++index) {
+    names.push_back("concurrent" + to_string(index));
+  }
+
+  vector<vector<Logger const*>> seen(threadCount);
+  vector<thread> threads;
+  for (auto index = 0; index < threadCount; ++index) {
+    threads.emplace_back([&names, &found = seen[index]] {
+      for (auto const& name : names) {
+        found.push_back(&Logger::get(name));
+      }
+    });
+  }
+  for (auto& worker : threads) {
+    worker.join();
+  }
+
+  for (auto index = 0; index < nameCount; ++index) {
+    ASSERT_TRUE(std::is_eq(StringRef {seen[0][index]->name()} <=> StringRef {names[index]}));
+    for (auto const& found : seen) {
+      ASSERT_EQ(found[index], seen[0][index]);
+    }
+  }
+}
+
+TEST(LoggerTest, shortLivedStreams) {
+  constexpr auto const threadCount = 4;
+  constexpr auto const streamCount = 2000;
+  atomic<int> mismatches {0};
+  vector<thread> threads;
+  for (auto index = 0; index < threadCount; ++index) {
+    threads.emplace_back([&mismatches] {
+      for (auto record = 0; record < streamCount; ++record) {
+        auto pOut = make_unique<stringstream>();
+        auto logger = Logger::get(*pOut);
+        logger.disableOptions(Logger::defaultOptionFlags);
+        auto copy = logger;
+        copy() << record;
+        if (pOut->str() != to_string(record) + "\n") {
+          ++mismatches;
+        }
+      }
+    });
+  }
+  for (auto& worker : threads) {
+    worker.join();
+  }
+  ASSERT_EQ(mismatches.load(), 0);
+}
+
+TEST(LoggerTest, manyLiveStreams) {
+  for (auto round = 0; round < 3; ++round) {
+    vector<unique_ptr<stringstream>> streams;
+    vector<Logger> loggers;
+    for (auto index = 0; index < 500; ++index) {
+      streams.push_back(make_unique<stringstream>());
+      loggers.push_back(Logger::get(*streams.back()));
+      loggers.back().disableOptions(Logger::defaultOptionFlags);
+    }
+
+    for (auto index = 0; index < 500; ++index) {
+      loggers[index]() << round << ' ' << index;
+    }
+
+    for (auto index = 0; index < 500; ++index) {
+      ASSERT_EQ(streams[index]->str(), to_string(round) + ' ' + to_string(index) + '\n');
+    }
+  }
+}
+
+TEST(LoggerTest, outputAssignment) {
+  auto pFirst = make_unique<stringstream>();
+  auto pSecond = make_unique<stringstream>();
+  LoggerOutput output {*pFirst};
+  LoggerOutput other {*pSecond};
+  output = other;
+  other = LoggerOutput {*pFirst, Logger::Level::Error};
+
+  {
+    auto logger = Logger::get(output, other);
+    logger.disableOptions(Logger::defaultOptionFlags);
+    logger() << "info";
+    logger(Logger::Level::Error) << "error";
+  }
+  ASSERT_EQ(pFirst->str(), "error\n");
+  ASSERT_EQ(pSecond->str(), "info\nerror\n");
+
+  output = LoggerOutput {cout};
+  other = std::move(output);
+  ASSERT_TRUE(other.writesTo(cout));
+}
+
 TEST(LoggerTest, timestampCoverage) {
   /// Pointless to compare timestamp correctly, since ms can shift it
   stringstream outbuf;
@@ -519,6 +697,147 @@ TEST(LoggerTest, timestampCoverage) {
   logger() << "test2";
 }
 
+TEST(LoggerTest, timestampPrecision) {
+  using enum age::meta::LogOptionFlagBits;
+  auto matches = [](auto options, char const* pattern) {
+    stringstream outbuf;
+    auto logger = Logger::get(outbuf);
+    logger.setOptions(options);
+    logger() << "test";
+    logger() << "test";
+    return regex_match(outbuf.str(), regex(pattern));
+  };
+
+  ASSERT_TRUE(matches(Timestamp, R"((\[\d\d:\d\d:\d\d\] test\n){2})"));
+  ASSERT_TRUE(matches(TimestampMilliseconds, R"((\[\d\d:\d\d:\d\d\.\d{3}\] test\n){2})"));
+  ASSERT_TRUE(matches(TimestampMicroseconds, R"((\[\d\d:\d\d:\d\d\.\d{6}\] test\n){2})"));
+  ASSERT_TRUE(matches(TimestampNanoseconds | TimestampMilliseconds, R"((\[\d\d:\d\d:\d\d\.\d{9}\] test\n){2})"));
+  ASSERT_TRUE(matches(MonotonicTimestamp, R"((\[\d+\] test\n){2})"));
+  ASSERT_TRUE(matches(MonotonicTimestamp | TimestampMicroseconds, R"((\[\d+\.\d{6}\] test\n){2})"));
+}
+
+TEST(LoggerTest, headerPlan) {
+  using enum age::meta::LogOptionFlagBits;
+  stringstream outbuf;
+  auto logger = Logger::get(outbuf);
+  logger.setOptions(SourceLocationLine | SourceLocationColumn | LogLevel | ThreadId | InfoPrefix);
+  logger() << "first";
+  logger.disableOptions(SourceLocation | ThreadId);
+  logger() << "second";
+  logger.setOptions(0u);
+  logger() << "third";
+
+  ASSERT_TRUE(regex_match(
+      outbuf.str(),
+      regex(R"(\[\d+:\d+\]\[level = Info\]\[thread = 0x[0-9a-f]+\] first\n\[level = Info\] second\nthird\n)")));
+}
+
+TEST(LoggerTest, colourCapability) {
+  stringstream outbuf;
+  auto logger = Logger::get(outbuf);
+  logger.setOptions(Logger::OptionFlag::OutputTerminalColour);
+  logger() << "plain";
+
+  ASSERT_FALSE(LoggerOutput(outbuf).colourCapable());
+  ASSERT_EQ(outbuf.str(), "plain\n");
+}
+
+TEST(LoggerTest, levelSeverity) {
+  using enum age::meta::LogLevelFlagBits;
+  static_assert(age::meta::levelsFrom(Debug) == age::meta::logLevelMask);
+  static_assert(age::meta::levelsFrom(Info) == (Info | Warning | Error));
+  static_assert(age::meta::levelsFrom(Error) == static_cast<age::meta::LogLevelFlags>(Error));
+  static_assert(age::meta::compiledLogLevels == age::meta::levelsFrom(age::meta::compiledMinimumLevel));
+}
+
+TEST(LoggerTest, minimumLevel) {
+  stringstream outbuf;
+  auto logger = Logger::get(outbuf);
+  logger.disableOptions(Logger::defaultOptionFlags);
+  logger.setMinimumLevel(Logger::Level::Warning);
+  ASSERT_FALSE(logger.enabled(Logger::Level::Debug));
+  ASSERT_FALSE(logger.enabled(Logger::Level::Info));
+  ASSERT_TRUE(logger.enabled(Logger::Level::Warning));
+
+  logger(Logger::Level::Debug) << "debug";
+  logger(Logger::Level::Info) << "info";
+  logger(Logger::Level::Warning) << "warning";
+  logger(Logger::Level::Error) << "error";
+  ASSERT_EQ(outbuf.str(), "warning\nerror\n");
+}
+
+TEST(LoggerTest, rejectedLevelSkipsFormatting) {
+  stringstream outbuf;
+  auto logger =
+      Logger::get(LoggerOutput(outbuf, LoggerOutput::allowError), LoggerOutput(outbuf, LoggerOutput::allowWarning));
+  logger.disableOptions(Logger::defaultOptionFlags);
+  ASSERT_FALSE(logger.enabled(Logger::Level::Info));
+
+  int formatted = 0;
+  logger(Logger::Level::Info) << CountedFormat {&formatted};
+  logger(Logger::Level::Error) << CountedFormat {&formatted};
+  ASSERT_EQ(formatted, 1);
+  ASSERT_EQ(outbuf.str(), "counted\n");
+}
+
+TEST(LoggerTest, rateLimitPerSite) {
+  stringstream outbuf;
+  auto logger = Logger::get(outbuf);
+  logger.setOptions(Logger::OptionFlag::RateLimitSite);
+  logger.setRateLimit(3u, chrono::minutes(1));
+
+  int formatted = 0;
+  for (auto index = 0; index < 10; ++index) {
+    logger() << CountedFormat {&formatted};
+  }
+  logger() << "other site";
+  ASSERT_EQ(formatted, 3);
+  ASSERT_EQ(outbuf.str(), "counted\ncounted\ncounted\nother site\n");
+}
+
+TEST(LoggerTest, samplingPerLogger) {
+  stringstream outbuf;
+  auto logger = Logger::get(outbuf);
+  logger.setOptions(Logger::OptionFlag::SampleLogger);
+  logger.setSampling(4u);
+
+  for (auto index = 0; index < 8; ++index) {
+    logger() << index;
+  }
+  logger() << 8;
+  ASSERT_EQ(outbuf.str(), "0\n4\n8\n");
+}
+
+TEST(LoggerTest, suppressedReport) {
+  stringstream outbuf;
+  auto logger = Logger::get(outbuf);
+  logger.setOptions(Logger::OptionFlag::RateLimitLogger);
+  logger.setRateLimit(1u, chrono::milliseconds(20));
+
+  logger() << "first";
+  logger() << "second";
+  logger() << "third";
+  this_thread::sleep_for(chrono::milliseconds(40));
+  logger(Logger::Level::Warning) << "fourth";
+  ASSERT_EQ(outbuf.str(), "first\nsuppressed 2 records\nfourth\n");
+}
+
+TEST(LoggerTest, suppressedReportWithoutAdmission) {
+  stringstream outbuf;
+  auto logger = Logger::get(outbuf);
+  logger.setOptions(Logger::OptionFlag::SampleLogger);
+  logger.setSampling(1000u);
+  // Only sets the report interval, since rate limiting is not enabled
+  logger.setRateLimit(1u, chrono::milliseconds(20));
+
+  for (auto index = 0; index < 4; ++index) {
+    logger() << "sampled " << index;
+  }
+  this_thread::sleep_for(chrono::milliseconds(40));
+  logger() << "sampled out";
+  ASSERT_EQ(outbuf.str(), "sampled 0\nsuppressed 4 records\n");
+}
+
 TEST(LoggerTest, otherCoverage) {
   using enum age::meta::LogOptionFlagBits;
   /// Other functions that just require coverage, do not make a difference
@@ -530,6 +849,182 @@ TEST(LoggerTest, otherCoverage) {
   (void) l2;
   (void) l3;
 }
+
+TEST(LoggerTest, asynchronous) {
+  stringstream outbuf;
+  auto logger = Logger::get(outbuf);
+  logger.setOptions(Logger::OptionFlag::Asynchronous);
+
+  logger() << "first";
+  logger(Logger::Level::Error) << "second";
+  Logger::flush();
+  ASSERT_EQ(outbuf.str(), "first\nsecond\n");
+}
+
+TEST(LoggerTest, flushPolicy) {
+  auto const path = filesystem::temp_directory_path() / "age_logger_flush_policy";
+  auto const contents = [&path] {
+    ifstream in(path);
+    return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+  };
+
+  {
+    ofstream file(path);
+    stringstream outbuf;
+    auto logger = Logger::get(file, outbuf);
+    logger.disableOptions(Logger::defaultOptionFlags);
+
+    logger(Logger::Level::Error) << "error";
+    ASSERT_EQ(contents(), "error\n");
+
+    logger.enableOptions(Logger::OptionFlag::Asynchronous);
+    for (auto index = 0; index < 100; ++index) {
+      logger() << "record " << index;
+    }
+    Logger::flush();
+    ASSERT_TRUE(contents().ends_with("record 99\n"));
+    ASSERT_EQ(contents().substr(6u), outbuf.str().substr(6u));
+  }
+  filesystem::remove(path);
+}
+
+TEST(LoggerTest, flushDeferred) {
+  auto const path = filesystem::temp_directory_path() / "age_logger_flush_deferred";
+  auto const contents = [&path] {
+    ifstream in(path);
+    return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+  };
+
+  {
+    ofstream file(path);
+    auto logger = Logger::get(file);
+    logger.disableOptions(Logger::defaultOptionFlags);
+
+    logger(Logger::Level::Error) << "first";
+    logger() << "second";
+    ASSERT_EQ(contents(), "first\n");
+
+    // Past the flush interval, the next record flushes what the previous one left buffered
+    this_thread::sleep_for(chrono::milliseconds(150));
+    logger() << "third";
+    ASSERT_EQ(contents(), "first\nsecond\nthird\n");
+  }
+  filesystem::remove(path);
+}
+
+TEST(LoggerTest, formatString) {
+  stringstream outbuf;
+  auto logger = Logger::get(outbuf);
+  logger.disableOptions(Logger::defaultOptionFlags);
+  logger.enableOptions(Logger::OptionFlag::LogLevel);
+
+  logger.info("loaded {} of {}", 3, 4);
+  logger.warning("{{literal}}");
+  logger.error("{}", string("error"));
+  logger.debug("{} {}", 'd', 1.5);
+  ASSERT_EQ(outbuf.str(), "[Info] loaded 3 of 4\n[Warning] {literal}\n[Error] error\n[Debug] d 1.5\n");
+}
+
+TEST(LoggerTest, formatStringFiltered) {
+  stringstream outbuf;
+  auto logger = Logger::get(outbuf);
+  logger.disableOptions(Logger::defaultOptionFlags);
+  logger.setMinimumLevel(Logger::Level::Error);
+
+  int formatted = 0;
+  logger.info("{}", CountedFormat {&formatted});
+  logger.error("{}", CountedFormat {&formatted});
+  ASSERT_EQ(formatted, 1);
+  ASSERT_EQ(outbuf.str(), "counted\n");
+}
+
+TEST(LoggerTest, formatStringDeferred) {
+  stringstream outbuf;
+  auto logger = Logger::get(outbuf);
+  logger.setOptions(Logger::OptionFlag::Asynchronous | Logger::OptionFlag::LoggerName);
+
+  {
+    string text = "copied";
+    logger.info("{} {}", text, text.c_str());
+    text.assign(64u, 'x');
+  }
+  {
+    auto anonymous = Logger::get(outbuf);
+    anonymous.setOptions(Logger::OptionFlag::Asynchronous);
+    anonymous.error("{}", 42);
+  }
+  Logger::flush();
+  ASSERT_EQ(outbuf.str(), "[anonymous_logger] copied copied\n42\n");
+}
+
+TEST(LoggerTest, formatStringDeferredViews) {
+  stringstream outbuf;
+  auto logger = Logger::get(outbuf);
+  logger.setOptions(Logger::OptionFlag::Asynchronous);
+
+  {
+    auto pText = make_unique<string>("referenced");
+    logger.info("{} {}", StringRef(*pText), cds::StringView(pText->c_str(), pText->size()));
+    pText->assign(64u, 'x');
+  }
+  Logger::flush();
+  ASSERT_EQ(outbuf.str(), "referenced referenced\n");
+}
+
+TEST(LoggerTest, formatStringDeferredBinary) {
+  stringstream text;
+  stringstream binary;
+  auto logger = Logger::get(LoggerOutput(text), LoggerOutput::binary(binary));
+  logger.setOptions(Logger::OptionFlag::Asynchronous);
+
+  logger.info("value {}", 42);
+  Logger::flush();
+  ASSERT_EQ(text.str(), "value 42\n");
+
+  stringstream decoded;
+  ASSERT_TRUE(age::meta::decodeBinaryLog(binary, decoded));
+  ASSERT_EQ(decoded.str(), text.str());
+}
+
+TEST(LoggerTest, asynchronousDropNewest) {
+  GatedBuffer gate;
+  ostream out(&gate);
+  auto logger = Logger::get(out);
+  AsyncConfiguration const configuration(2u, Logger::OverflowPolicy::DropNewest, gate);
+  logger.setOptions(Logger::OptionFlag::Asynchronous);
+
+  logger() << "r0";
+  gate.awaitBlocked();
+  logger() << "r1";
+  logger() << "r2";
+  logger() << "r3";
+  logger() << "r4";
+  ASSERT_EQ(Logger::droppedRecords(), 2u);
+
+  gate.open();
+  Logger::flush();
+  ASSERT_EQ(gate.str(), "r0\nr1\nr2\n");
+}
+
+TEST(LoggerTest, asynchronousDropOldest) {
+  GatedBuffer gate;
+  ostream out(&gate);
+  auto logger = Logger::get(out);
+  AsyncConfiguration const configuration(2u, Logger::OverflowPolicy::DropOldest, gate);
+  logger.setOptions(Logger::OptionFlag::Asynchronous);
+
+  logger() << "r0";
+  gate.awaitBlocked();
+  logger() << "r1";
+  logger() << "r2";
+  logger() << "r3";
+  logger() << "r4";
+  ASSERT_EQ(Logger::droppedRecords(), 2u);
+
+  gate.open();
+  Logger::flush();
+  ASSERT_EQ(gate.str(), "r0\nr3\nr4\n");
+}
 #else
 TEST(LoggerTest, basicOut) {
   stringstream outbuf;
@@ -858,4 +1353,36 @@ TEST(LoggerTest, otherCoverage) {
   (void) l2;
   (void) l3;
 }
+
+TEST(LoggerTest, asynchronous) {
+  stringstream outbuf;
+  auto logger = Logger::get(outbuf);
+  logger.setOptions(Logger::OptionFlag::Asynchronous);
+
+  logger() << "first";
+  logger(Logger::Level::Error) << "second";
+  Logger::flush();
+  ASSERT_TRUE(outbuf.str().empty());
+  ASSERT_EQ(Logger::droppedRecords(), 0u);
+}
+
+TEST(LoggerTest, throttlingEliminated) {
+  stringstream outbuf;
+  auto logger = Logger::get(outbuf);
+  logger.setOptions(Logger::OptionFlag::RateLimitSite | Logger::OptionFlag::SampleLogger);
+  logger.setRateLimit(1u);
+  logger.setSampling(2u);
+  logger(Logger::Level::Error) << "error";
+  ASSERT_TRUE(outbuf.str().empty());
+}
+
+TEST(LoggerTest, levelsEliminated) {
+  static_assert(age::meta::compiledLogLevels == 0u);
+  stringstream outbuf;
+  auto logger = Logger::get(outbuf);
+  int formatted = 0;
+  logger(Logger::Level::Error) << CountedFormat {&formatted};
+  ASSERT_FALSE(logger.enabled(Logger::Level::Error));
+  ASSERT_EQ(formatted, 0);
+}
 #endif
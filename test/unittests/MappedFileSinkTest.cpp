@@ -0,0 +1,143 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <core/logging/BinaryLogFormat.hpp>
+#include <core/logging/Logger.hpp>
+#include <core/logging/MappedFileSink.hpp>
+
+#if defined(__linux) | defined(__APPLE__)
+namespace {
+using age::Logger;
+using age::LoggerOutput;
+using age::MappedFileConfig;
+using age::MappedFileSink;
+
+auto read(std::filesystem::path const& path) {
+  std::ifstream in(path, std::ios::binary);
+  std::stringstream contents;
+  contents << in.rdbuf();
+  return contents.str();
+}
+
+class MappedFileSinkTest : public testing::Test {
+protected:
+  auto SetUp() -> void override {
+    _directory = std::filesystem::temp_directory_path()
+        / ("age_mapped_" + std::string(testing::UnitTest::GetInstance()->current_test_info()->name()));
+    std::filesystem::remove_all(_directory);
+  }
+
+  auto TearDown() -> void override { std::filesystem::remove_all(_directory); }
+
+  [[nodiscard]] auto config() const {
+    MappedFileConfig config;
+    config.path = _directory / "log.txt";
+    config.chunkSize = 1u;
+    return config;
+  }
+
+  std::filesystem::path _directory;
+};
+} // namespace
+
+TEST_F(MappedFileSinkTest, writesAcrossChunks) {
+  std::string expected;
+  {
+    MappedFileSink file(config());
+    ASSERT_TRUE(file.isOpen());
+    for (auto index = 0; index < 2000; ++index) {
+      file << "line " << index << '\n';
+      expected += "line " + std::to_string(index) + '\n';
+    }
+  }
+  ASSERT_EQ(read(config().path), expected);
+}
+
+TEST_F(MappedFileSinkTest, appendsToExistingFile) {
+  {
+    MappedFileSink file(config());
+    file << "first\n";
+  }
+  {
+    MappedFileSink file(config());
+    file << "second\n";
+  }
+  ASSERT_EQ(read(config().path), "first\nsecond\n");
+}
+
+TEST_F(MappedFileSinkTest, rotatesBySize) {
+  auto rotating = config();
+  rotating.rotateSize = 16u;
+  rotating.backups = 2u;
+  {
+    MappedFileSink file(rotating);
+    for (auto index = 0; index < 4; ++index) {
+      file << "record number " << index << std::endl;
+    }
+  }
+
+  auto const backup = [&rotating](char const* suffix) {
+    auto path = rotating.path;
+    path += suffix;
+    return read(path);
+  };
+  ASSERT_EQ(backup(".2"), "record number 2\n");
+  ASSERT_EQ(backup(".1"), "record number 3\n");
+  ASSERT_EQ(read(rotating.path), "");
+}
+
+#ifndef NDEBUG
+TEST_F(MappedFileSinkTest, loggerOutput) {
+  MappedFileSink file(config());
+  std::stringstream text;
+  auto logger = Logger::get(file, text);
+  logger.disableOptions(Logger::defaultOptionFlags);
+  logger() << "to file " << 1;
+  logger(Logger::Level::Error) << "to file " << 2;
+  file.flush();
+
+  ASSERT_EQ(text.str(), "to file 1\nto file 2\n");
+  ASSERT_EQ(read(config().path).substr(0u, text.str().size()), text.str());
+}
+
+TEST_F(MappedFileSinkTest, binaryOutputAcrossRotations) {
+  auto const decoded = [](std::filesystem::path const& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream out;
+    return age::meta::decodeBinaryLog(in, out) ? out.str() : std::string("invalid");
+  };
+
+  auto rotating = config();
+  rotating.path = _directory / "log.bin";
+  std::stringstream text;
+  {
+    MappedFileSink file(rotating);
+    auto logger = Logger::get(LoggerOutput::binary(file), LoggerOutput(text));
+    logger.disableOptions(Logger::defaultOptionFlags);
+    logger() << "before";
+    file.rotate();
+    logger() << "after";
+  }
+  {
+    MappedFileSink file(rotating);
+    auto logger = Logger::get(LoggerOutput::binary(file), LoggerOutput(text));
+    logger.disableOptions(Logger::defaultOptionFlags);
+    logger() << "reopened";
+  }
+
+  auto backup = rotating.path;
+  backup += ".1";
+  ASSERT_EQ(decoded(backup), "before\n");
+  ASSERT_EQ(decoded(rotating.path), "after\nreopened\n");
+  ASSERT_EQ(text.str(), "before\nafter\nreopened\n");
+}
+#endif
+#endif
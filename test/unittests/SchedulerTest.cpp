@@ -0,0 +1,104 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <lang/thread/Scheduler.hpp>
+
+namespace {
+using age::Scheduler;
+using age::TaskGroup;
+
+auto fib(Scheduler& scheduler, int n) -> long {
+  if (n < 2) {
+    return n;
+  }
+
+  long left = 0;
+  TaskGroup group(scheduler);
+  group.spawn([&scheduler, &left, n] { left = fib(scheduler, n - 1); });
+  auto const right = fib(scheduler, n - 2);
+  group.join();
+  return left + right;
+}
+} // namespace
+
+TEST(SchedulerTest, spawnAndJoin) {
+  Scheduler scheduler(4u);
+  ASSERT_EQ(scheduler.threadCount(), 4u);
+
+  std::atomic<int> sum {0};
+  for (auto index = 1; index <= 1000; ++index) {
+    scheduler.spawn([&sum, index] { sum.fetch_add(index, std::memory_order_relaxed); });
+  }
+  scheduler.join();
+  ASSERT_EQ(sum.load(), 500500);
+}
+
+TEST(SchedulerTest, nestedSpawnsAreJoined) {
+  Scheduler scheduler(3u);
+  std::atomic<int> leaves {0};
+  for (auto outer = 0; outer < 16; ++outer) {
+    scheduler.spawn([&scheduler, &leaves] {
+      for (auto inner = 0; inner < 16; ++inner) {
+        scheduler.spawn([&leaves] { leaves.fetch_add(1, std::memory_order_relaxed); });
+      }
+    });
+  }
+  scheduler.join();
+  ASSERT_EQ(leaves.load(), 256);
+}
+
+TEST(SchedulerTest, taskGroups) {
+  Scheduler scheduler(4u);
+  ASSERT_EQ(fib(scheduler, 20), 6765);
+
+  Scheduler single(1u);
+  ASSERT_EQ(fib(single, 15), 610);
+}
+
+TEST(SchedulerTest, joinFromSeveralThreads) {
+  Scheduler scheduler(2u);
+  std::vector<std::thread> threads;
+  std::atomic<long> total {0};
+  for (auto thread = 0; thread < 4; ++thread) {
+    threads.emplace_back([&scheduler, &total] { total.fetch_add(fib(scheduler, 12)); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(total.load(), 4 * 144);
+}
+
+TEST(SchedulerTest, shortLivedGroups) {
+  Scheduler scheduler(4u);
+  std::atomic<int> runs {0};
+  for (auto round = 0; round < 2000; ++round) {
+    TaskGroup group(scheduler);
+    group.spawn([&runs] { runs.fetch_add(1, std::memory_order_relaxed); });
+  }
+  ASSERT_EQ(runs.load(), 2000);
+}
+
+TEST(SchedulerTest, parallelFor) {
+  Scheduler scheduler(4u);
+  std::vector<int> visits(10007, 0);
+  age::parallelFor(scheduler, 0, static_cast<int>(visits.size()), 64, [&visits](int index) { ++visits[index]; });
+  for (auto count : visits) {
+    ASSERT_EQ(count, 1);
+  }
+}
+
+TEST(SchedulerTest, parallelForWithoutGrain) {
+  Scheduler scheduler(4u);
+  std::vector<int> visits(1000, 0);
+  age::parallelFor(scheduler, 0, static_cast<int>(visits.size()), 0, [&visits](int index) { ++visits[index]; });
+  for (auto count : visits) {
+    ASSERT_EQ(count, 1);
+  }
+}
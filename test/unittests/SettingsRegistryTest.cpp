@@ -9,6 +9,7 @@
 #include <CDS/filesystem/Path>
 
 namespace {
+using age::visualizer::settings::Registry;
 using age::visualizer::settings::registry;
 using namespace cds::json;
 } // namespace
@@ -94,6 +95,46 @@ TEST(SettingsRegistryTest, preemptiveLoad) {
   ASSERT_EQ(r.getString("testJson.testStr"), "testSub");
 }
 
+TEST(SettingsRegistryTest, keys) {
+  static_assert(Registry::Key {"testJson.testStr"}.depth() == 2u);
+  static_assert(Registry::Key {"testJson.testStr"}.segment(1u) == "testStr");
+  static constinit Registry::Key const testStr {"testJson.testStr"};
+  static constinit Registry::Key const testInt {"testInt"};
+
+  auto& r = registry();
+  auto const& cr = registry();
+  ASSERT_EQ(cr.getInt(testInt), 0);
+  ASSERT_EQ(cr.getString(testStr), "testSub");
+
+  r.getString("testJson.testStr") = "keyTest";
+  ASSERT_EQ(cr.getString(testStr), "keyTest");
+
+  r.replace("testJson", JsonObject());
+  ASSERT_THROW((void) cr.getString(testStr), cds::KeyException);
+  r.reset("testJson");
+  ASSERT_EQ(cr.getString(testStr), "testSub");
+  ASSERT_EQ(cr.getJson(Registry::Key {"testJson"}).size(), 1u);
+}
+
+TEST(SettingsRegistryTest, keysWithLentGroup) {
+  static constinit Registry::Key const testStr {"testJson.testStr"};
+
+  auto& r = registry();
+  auto const& cr = registry();
+  ASSERT_EQ(cr.getString(testStr), "testSub");
+
+  auto& group = r.getJson("testJson");
+  ASSERT_EQ(cr.getString(testStr), "testSub");
+  group = JsonObject();
+  ASSERT_THROW((void) cr.getString(testStr), cds::KeyException);
+  group.put("testStr", "lent");
+  ASSERT_EQ(cr.getString(testStr), "lent");
+
+  r.reset("testJson");
+  ASSERT_EQ(cr.getString(testStr), "testSub");
+  ASSERT_EQ(cr.getString(testStr), "testSub");
+}
+
 TEST(SettingsRegistryTest, put) {
   auto& r = registry();
   r.put("put_testStr1", "test1");
@@ -128,6 +169,20 @@ TEST(SettingsRegistryTest, reset) {
   ASSERT_THROW((void) r.getJson("testJson").getString("reset_testStr1"), cds::KeyException);
 }
 
+TEST(SettingsRegistryTest, resetChangedGroups) {
+  auto& r = registry();
+  r.put("reset_json.nested.testStr1", "test1");
+  r.put("testJson.reset_json.testStr1", "test2");
+  r.replace("testStr", JsonObject());
+  ASSERT_TRUE(r.getJson("testStr").empty());
+
+  r.reset();
+  ASSERT_THROW((void) r.getJson("reset_json"), cds::KeyException);
+  ASSERT_THROW((void) r.getJson("testJson.reset_json"), cds::KeyException);
+  ASSERT_EQ(r.getString("testStr"), "test");
+  ASSERT_EQ(r.getJson("testJson").size(), 1u);
+}
+
 TEST(SettingsRegistryTest, save) {
   auto& r = registry();
 
@@ -196,6 +251,22 @@ TEST(SettingsRegistryTest, extrasForCoverage) {
   r.save();
 }
 
+TEST(SettingsRegistryTest, saveChangedGroups) {
+  auto& r = registry();
+  Registry::awaitPending();
+  std::filesystem::remove("./config/testJson.json");
+
+  r.replace("testBoolTrue", true);
+  r.save();
+  Registry::awaitPending();
+  ASSERT_FALSE(std::filesystem::exists("./config/testJson.json"));
+
+  r.getString("testJson.testStr") = "test4";
+  r.save();
+  Registry::awaitPending();
+  ASSERT_TRUE(std::filesystem::exists("./config/testJson.json"));
+}
+
 TEST(SettingsRegistryTest, checkSavedConfigs) {
   age::visualizer::settings::Registry::awaitPending();
   ASSERT_TRUE(std::filesystem::exists("./config"));
@@ -0,0 +1,144 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <lang/coro/Awaiters.hpp>
+#include <lang/coro/Task.hpp>
+#include <lang/filesystem/AsyncFile.hpp>
+#include <lang/thread/Dispatcher.hpp>
+#include <lang/thread/Executor.hpp>
+
+namespace {
+using namespace age;
+
+auto value(int v) -> Task<int> { co_return v; }
+
+auto sum(int count) -> Task<long> {
+  long total = 0;
+  for (auto index = 0; index < count; ++index) {
+    total += co_await value(index);
+  }
+  co_return total;
+}
+
+auto failing() -> Task<int> {
+  throw std::runtime_error("failed");
+  co_return 0;
+}
+
+auto onWorker(Executor& executor) -> Task<std::thread::id> {
+  co_await resumeOn(executor);
+  co_return std::this_thread::get_id();
+}
+
+auto backAndForth(Executor& executor, Dispatcher& dispatcher, std::thread::id& computedOn) -> Task<std::thread::id> {
+  co_await resumeOn(executor);
+  computedOn = std::this_thread::get_id();
+  co_await resumeOn(dispatcher);
+  co_return std::this_thread::get_id();
+}
+} // namespace
+
+TEST(TaskTest, awaitsNestedTasks) { ASSERT_EQ(launch(sum(10)).get(), 45); }
+
+TEST(TaskTest, longChainsOfReadyTasks) { ASSERT_EQ(launch(sum(10000)).get(), 49995000L); }
+
+TEST(TaskTest, exceptionsReachTheAwaiter) {
+  auto const caught = []() -> Task<bool> {
+    try {
+      (void) co_await failing();
+    } catch (std::runtime_error const&) {
+      co_return true;
+    }
+    co_return false;
+  };
+
+  ASSERT_TRUE(launch(caught()).get());
+  ASSERT_THROW((void) launch(failing()).get(), std::runtime_error);
+}
+
+TEST(TaskTest, resumesOnExecutor) {
+  Executor executor(1u);
+  ASSERT_NE(launch(onWorker(executor)).get(), std::this_thread::get_id());
+}
+
+TEST(TaskTest, resumesOnDispatcher) {
+  Executor executor(1u);
+  Dispatcher dispatcher;
+  std::thread::id computedOn;
+  auto const future = launch(backAndForth(executor, dispatcher, computedOn));
+
+  // Only the owner's drain resumes the coroutine
+  while (dispatcher.drain() == 0u) {
+    std::this_thread::yield();
+  }
+  ASSERT_EQ(future.get(), std::this_thread::get_id());
+  ASSERT_NE(computedOn, std::this_thread::get_id());
+}
+
+TEST(TaskTest, dispatcherWakeup) {
+  Dispatcher dispatcher;
+  auto wakeups = 0;
+  auto ran = 0;
+  dispatcher.submit([&ran] { ++ran; });
+  dispatcher.setWakeup([&wakeups] { ++wakeups; });
+  ASSERT_EQ(wakeups, 1);
+
+  // The batch already queued has its drain scheduled
+  dispatcher.submit([&ran] { ++ran; });
+  ASSERT_EQ(wakeups, 1);
+  ASSERT_EQ(dispatcher.drain(), 2u);
+  dispatcher.submit([&ran] { ++ran; });
+  ASSERT_EQ(wakeups, 2);
+  ASSERT_EQ(dispatcher.drain(), 1u);
+  ASSERT_EQ(ran, 3);
+}
+
+TEST(TaskTest, dispatcherKeepsTasksAfterThrow) {
+  Dispatcher dispatcher;
+  auto wakeups = 0;
+  auto ran = 0;
+  dispatcher.setWakeup([&wakeups] { ++wakeups; });
+  dispatcher.submit([&ran] { ++ran; });
+  dispatcher.submit([] { throw std::runtime_error("failed"); });
+  dispatcher.submit([&ran] { ++ran; });
+  dispatcher.submit([&ran] { ++ran; });
+  ASSERT_EQ(wakeups, 1);
+
+  // The tasks left behind get a drain of their own
+  ASSERT_THROW((void) dispatcher.drain(), std::runtime_error);
+  ASSERT_EQ(ran, 1);
+  ASSERT_EQ(wakeups, 2);
+  ASSERT_EQ(dispatcher.drain(), 2u);
+  ASSERT_EQ(ran, 3);
+}
+
+#ifndef NDEBUG
+TEST(TaskTest, awaitingMovedFromTask) {
+  auto const awaiting = [](Task<int>& task) -> Task<int> { co_return co_await task; };
+  auto task = value(1);
+  auto const moved = std::move(task);
+  ASSERT_DEATH((void) launch(awaiting(task)).get(), "moved-from Task");
+}
+#endif
+
+TEST(TaskTest, awaitsFileIo) {
+  Executor executor(1u);
+  auto const path = std::filesystem::temp_directory_path() / "age_task_test" / "settings.json";
+  auto const roundTrip = [&executor, &path]() -> Task<std::string> {
+    co_await writeFile(path, "{\"a\": 1}", executor);
+    co_return co_await readFile(path, executor);
+  };
+  auto const readBack = [&executor, &path]() -> Task<std::string> { co_return co_await readFile(path, executor); };
+
+  ASSERT_EQ(launch(roundTrip()).get(), "{\"a\": 1}");
+  std::filesystem::remove_all(path.parent_path());
+  ASSERT_THROW((void) launch(readBack()).get(), std::ios_base::failure);
+}
@@ -0,0 +1,71 @@
+//
+// Created by loghin on 10/18/26.
+//
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <lang/thread/WorkStealingDeque.hpp>
+
+namespace {
+using age::meta::WorkStealingDeque;
+} // namespace
+
+TEST(WorkStealingDequeTest, ownerIsLifoThiefIsFifo) {
+  int values[4] {0, 1, 2, 3};
+  WorkStealingDeque<int*> deque(2u);
+  ASSERT_TRUE(deque.empty());
+  for (auto& value : values) {
+    deque.push(&value);
+  }
+
+  ASSERT_EQ(deque.pop(), &values[3]);
+  ASSERT_EQ(deque.steal(), &values[0]);
+  ASSERT_EQ(deque.pop(), &values[2]);
+  ASSERT_EQ(deque.steal(), &values[1]);
+  ASSERT_EQ(deque.pop(), nullptr);
+  ASSERT_EQ(deque.steal(), nullptr);
+  ASSERT_TRUE(deque.empty());
+}
+
+TEST(WorkStealingDequeTest, everyItemTakenOnce) {
+  constexpr auto const count = 100000;
+  std::vector<std::atomic<int>> taken(count);
+  std::vector<int> items(count);
+  WorkStealingDeque<int*> deque(16u);
+  std::atomic<bool> done {false};
+
+  std::vector<std::thread> thieves;
+  for (auto thief = 0; thief < 3; ++thief) {
+    thieves.emplace_back([&] {
+      while (!done.load(std::memory_order_acquire) || !deque.empty()) {
+        if (auto* pItem = deque.steal(); pItem != nullptr) {
+          taken[pItem - items.data()].fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    });
+  }
+
+  for (auto index = 0; index < count; ++index) {
+    deque.push(&items[index]);
+    if (index % 3 == 0) {
+      if (auto* pItem = deque.pop(); pItem != nullptr) {
+        taken[pItem - items.data()].fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+  }
+  while (auto* pItem = deque.pop()) {
+    taken[pItem - items.data()].fetch_add(1, std::memory_order_relaxed);
+  }
+  done.store(true, std::memory_order_release);
+  for (auto& thief : thieves) {
+    thief.join();
+  }
+
+  for (auto const& counter : taken) {
+    ASSERT_EQ(counter.load(), 1);
+  }
+}